@@ -0,0 +1,72 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include "sprites.h"
+
+//----------------------------------------------------------------------------------
+// Some Defines
+//----------------------------------------------------------------------------------
+// Built by `make pack`, the game falls back to the loose files without it
+#define ASSET_PACK_FILE "Assets/assets.pak"
+
+// Loaded in main() before the first frame, for the logo and loading screens
+#define ICON_FILE "Assets/NinjaAdventure/icon.png"
+#define LOGO_BACKGROUND_FILE "Assets/NinjaAdventure/Backgrounds/background.png"
+#define LOADING_BACKGROUND_FILE "Assets/NinjaAdventure/Backgrounds/loading.png"
+#define MENU_MUSIC_FILE "Assets/NinjaAdventure/Musics/1 - Adventure Begin.ogg"
+
+// Wave definitions, compiled by waves.c when the game starts
+#define WAVES_FILE "Assets/waves.txt"
+
+#define BOOT_ASSET_LIST(X) \
+    X(ASSET_TEXTURE, ICON_FILE) \
+    X(ASSET_TEXTURE, LOGO_BACKGROUND_FILE) \
+    X(ASSET_TEXTURE, LOADING_BACKGROUND_FILE) \
+    X(ASSET_MUSIC, MENU_MUSIC_FILE)
+
+// Everything the asset loader streams in, in load order: type, group, file, target, volume
+// and voices. The gameplay sprites from sprites.h follow them. Tools expand the list
+// without the targets, which only exist in main.c.
+#define ASSET_LIST(X) \
+    X(ASSET_TEXTURE, ASSET_GROUP_TITLE, "Assets/NinjaAdventure/Backgrounds/backgroud_titlescreen.png", &backgroundTitle, 0, 0) \
+    X(ASSET_TEXTURE, ASSET_GROUP_TITLE, "Assets/NinjaAdventure/Backgrounds/credits.png", &credits, 0, 0) \
+    X(ASSET_TEXTURE, ASSET_GROUP_TITLE, "Assets/NinjaAdventure/HUD/play_c.png", &buttonIdle, 0, 0) \
+    X(ASSET_TEXTURE, ASSET_GROUP_TITLE, "Assets/NinjaAdventure/HUD/play_d.png", &buttonDown, 0, 0) \
+    X(ASSET_TEXTURE, ASSET_GROUP_TITLE, "Assets/NinjaAdventure/HUD/credits_a.png", &creditsIdle, 0, 0) \
+    X(ASSET_TEXTURE, ASSET_GROUP_TITLE, "Assets/NinjaAdventure/HUD/credits_d.png", &creditsDown, 0, 0) \
+    X(ASSET_SOUND, ASSET_GROUP_TITLE, "Assets/NinjaAdventure/Sounds/Menu/Menu9.wav", &fxButton, 0.4f, 0) \
+    \
+    X(ASSET_TEXTURE, ASSET_GROUP_NARRATIVE, "Assets/NinjaAdventure/Backgrounds/narrative.png", &narrative, 0, 0) \
+    X(ASSET_MUSIC, ASSET_GROUP_NARRATIVE, "Assets/NinjaAdventure/Musics/13 - Mystical.ogg", &narrativeMusic.song, 0.4f, 0) \
+    X(ASSET_SOUND, ASSET_GROUP_NARRATIVE, "Assets/NinjaAdventure/Sounds/Menu/Menu1.wav", &continueNarrative.sound, 0.6f, 0) \
+    \
+    X(ASSET_TEXTURE, ASSET_GROUP_GAMEPLAY, "Assets/NinjaAdventure/Backgrounds/backgroundMain.png", &backgroundMain, 0, 0) \
+    X(ASSET_TEXTURE, ASSET_GROUP_GAMEPLAY, "Assets/NinjaAdventure/Backgrounds/rules.png", &rules, 0, 0) \
+    X(ASSET_MUSIC, ASSET_GROUP_GAMEPLAY, "Assets/NinjaAdventure/Musics/4 - Village.ogg", &backgroundMusic.song, 0.2f, 0) \
+    X(ASSET_SFX, ASSET_GROUP_GAMEPLAY, "Assets/NinjaAdventure/Sounds/Game/GameOver.wav", &gameOverSound, 0.5f, 1) \
+    X(ASSET_SFX, ASSET_GROUP_GAMEPLAY, "Assets/NinjaAdventure/Sounds/Game/Hit4.wav", &damageTaken, 0.2f, 2) \
+    X(ASSET_SFX, ASSET_GROUP_GAMEPLAY, "Assets/NinjaAdventure/Sounds/Game/Sword2.wav", &damageDone, 0.2f, 4) \
+    X(ASSET_ATLAS, ASSET_GROUP_GAMEPLAY, ATLAS_IMAGE_FILE, &atlasTexture, 0, 0)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum AssetType
+{
+    ASSET_TEXTURE = 0,
+    ASSET_SPRITE, // Loose gameplay sprite, skipped when the atlas is there
+    ASSET_ATLAS,  // Atlas page, skipped when it isn't
+    ASSET_SOUND,
+    ASSET_SFX, // Pooled effect that may overlap itself, the target is its SFX id
+    ASSET_MUSIC
+} AssetType;
+
+// Assets load in group order; a screen can be entered once its group is uploaded
+typedef enum AssetGroup
+{
+    ASSET_GROUP_TITLE = 0,
+    ASSET_GROUP_NARRATIVE,
+    ASSET_GROUP_GAMEPLAY
+} AssetGroup;
+
+#endif // ASSETS_H
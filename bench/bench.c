@@ -0,0 +1,248 @@
+/*******************************************************************************************
+*
+*   Gameplay benchmark - runs the headless core through fixed scenarios and reports
+*   ns per tick (p50/p99/max) for each GameStep() subsystem
+*
+*   Build and run with: make bench
+*   Usage: bench [ticks]
+*
+********************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "game.h"
+
+#if defined(_WIN32)
+// windows.h clashes with raylib.h (pulled in by game.h), declare only what we need
+typedef union { struct { unsigned long low; long high; } parts; long long quad; } BenchLargeInteger;
+__declspec(dllimport) int __stdcall QueryPerformanceCounter(BenchLargeInteger *count);
+__declspec(dllimport) int __stdcall QueryPerformanceFrequency(BenchLargeInteger *frequency);
+#else
+#include <time.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Some Defines
+//----------------------------------------------------------------------------------
+#define BENCH_SEED 12345
+#define BENCH_WIDTH GAME_WIDTH // Same field as the game, so the enemy density matches
+#define BENCH_HEIGHT GAME_HEIGHT
+#define BENCH_WARMUP_TICKS 120
+#define BENCH_DEFAULT_TICKS 600
+#define BENCH_TURN_TICKS 120 // Scripted input changes direction this often
+#define BENCH_ENEMY_LIFE 1000000 // Keeps the population steady while shurikens keep hitting
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct Scenario
+{
+    const char *name;
+    int wave; // Index into the built-in waves
+    int enemies;
+    bool fire;            // Hold the fire button like a player would
+    bool saturateShoots;  // Keep NUM_SHOOTS shurikens in flight every tick
+} Scenario;
+
+typedef struct Timing
+{
+    long long stageStart[GAME_STAGE_COUNT];
+    long long stageTotal[GAME_STAGE_COUNT]; // Accumulated over the current tick
+} Timing;
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+static const Scenario scenarios[] = {
+    { "first wave (20)", 0, 20, true, false },
+    { "survive wave (60)", 4, 60, true, false },
+    { "1k enemies", 4, 1000, true, false },
+    { "10k enemies", 4, 10000, true, false },
+    { "saturated shoots", 4, 60, false, true },
+};
+
+static const char *stageNames[GAME_STAGE_COUNT] = {
+    "wave", "player", "approach", "separation", "chase", "animation", "shoots", "collision", "release"
+};
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//------------------------------------------------------------------------------------
+static long long NowNs(void);
+static void OnStage(GameStage stage, bool begin, void *userData);
+static int CompareTimes(const void *a, const void *b);
+static void PrintRow(const char *name, long long *samples, int count);
+static void RunScenario(const Scenario *scenario, int ticks);
+
+//------------------------------------------------------------------------------------
+// Program main entry point
+//------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    int ticks = BENCH_DEFAULT_TICKS;
+
+    if (argc > 1)
+        ticks = atoi(argv[1]);
+
+    if (ticks <= 0)
+    {
+        fprintf(stderr, "usage: %s [ticks]\n", argv[0]);
+        return 1;
+    }
+
+    printf("%d ticks per scenario after %d warmup ticks, ns per tick\n", ticks, BENCH_WARMUP_TICKS);
+
+    for (int i = 0; i < (int)(sizeof(scenarios) / sizeof(scenarios[0])); i++)
+        RunScenario(&scenarios[i], ticks);
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------------
+// Module Functions Definition
+//------------------------------------------------------------------------------------
+static long long NowNs(void)
+{
+#if defined(_WIN32)
+    static long long frequency = 0;
+    BenchLargeInteger counter;
+
+    if (frequency == 0)
+    {
+        BenchLargeInteger f;
+        QueryPerformanceFrequency(&f);
+        frequency = f.quad;
+    }
+
+    QueryPerformanceCounter(&counter);
+
+    return (long long)((double)counter.quad * 1e9 / (double)frequency);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#endif
+}
+
+// Collision runs in several pieces per tick (player and every shuriken), so stages accumulate
+static void OnStage(GameStage stage, bool begin, void *userData)
+{
+    Timing *timing = (Timing *)userData;
+    long long now = NowNs();
+
+    if (begin)
+        timing->stageStart[stage] = now;
+    else
+        timing->stageTotal[stage] += now - timing->stageStart[stage];
+}
+
+static int CompareTimes(const void *a, const void *b)
+{
+    long long x = *(const long long *)a;
+    long long y = *(const long long *)b;
+
+    return (x > y) - (x < y);
+}
+
+static void PrintRow(const char *name, long long *samples, int count)
+{
+    qsort(samples, count, sizeof(long long), CompareTimes);
+
+    int p99 = (int)((long long)count * 99 / 100);
+
+    if (p99 >= count)
+        p99 = count - 1;
+
+    printf("  %-12s %10lld %10lld %10lld\n", name, samples[count / 2], samples[p99], samples[count - 1]);
+}
+
+static void RunScenario(const Scenario *scenario, int ticks)
+{
+    static GameState state = {0}; // Too big for the stack with the grid tables
+    Timing timing = {0};
+    long long *samples[GAME_STAGE_COUNT + 1];
+
+    for (int s = 0; s <= GAME_STAGE_COUNT; s++)
+    {
+        samples[s] = (long long *)malloc(ticks * sizeof(long long));
+
+        if (samples[s] == NULL)
+        {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+    }
+
+    GameInit(&state, BENCH_SEED, BENCH_WIDTH, BENCH_HEIGHT);
+    state.hooks.onStage = OnStage;
+    state.hooks.userData = &timing;
+    state.wave = scenario->wave;
+    state.activeEnemies = scenario->enemies;
+
+    GameInput input = {0};
+    input.screenWidth = BENCH_WIDTH;
+    input.screenHeight = BENCH_HEIGHT;
+    input.fire = scenario->fire;
+
+    for (int tick = 0; tick < BENCH_WARMUP_TICKS + ticks; tick++)
+    {
+        // Scripted input: walk in a slow loop around the screen
+        int turn = (tick / BENCH_TURN_TICKS) % 4;
+
+        input.right = (turn == 0);
+        input.down = (turn == 1);
+        input.left = (turn == 2);
+        input.up = (turn == 3);
+
+        // The player never dies, and nothing leaves the wave
+        state.lifeCount = 3;
+
+        if (tick == 1)
+        {
+            GameFlushSpawns(&state); // Measure the whole wave, not its spawn curve
+
+            for (int i = 0; i < state.enemies.count; i++)
+                state.enemies.life[i] = BENCH_ENEMY_LIFE;
+        }
+
+        if (scenario->saturateShoots)
+        {
+            while (state.shootCount < NUM_SHOOTS)
+            {
+                if (GameSpawnShoot(&state, state.shootCount % 8) == NULL)
+                    break;
+            }
+        }
+
+        memset(timing.stageTotal, 0, sizeof(timing.stageTotal));
+
+        long long start = NowNs();
+        GameStep(&state, &input);
+        long long total = NowNs() - start;
+
+        if (tick >= BENCH_WARMUP_TICKS)
+        {
+            int sample = tick - BENCH_WARMUP_TICKS;
+
+            for (int s = 0; s < GAME_STAGE_COUNT; s++)
+                samples[s][sample] = timing.stageTotal[s];
+
+            samples[GAME_STAGE_COUNT][sample] = total;
+        }
+    }
+
+    printf("\n%s: %d enemies, %d shoots at the end\n", scenario->name, state.enemies.count, state.shootCount);
+    printf("  %-12s %10s %10s %10s\n", "stage", "p50", "p99", "max");
+
+    for (int s = 0; s < GAME_STAGE_COUNT; s++)
+        PrintRow(stageNames[s], samples[s], ticks);
+
+    PrintRow("total", samples[GAME_STAGE_COUNT], ticks);
+
+    for (int s = 0; s <= GAME_STAGE_COUNT; s++)
+        free(samples[s]);
+
+    GameFree(&state);
+}
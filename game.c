@@ -0,0 +1,1461 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "game.h"
+#include "waves.h"
+
+// Gameplay simulation: waves, player, enemies and shurikens. Nothing in here calls
+// into raylib (window, input, audio or drawing), so it links and runs headless.
+// The frontend feeds a GameInput every tick and reacts to events through GameHooks.
+
+// The movement kernels use GCC/Clang vector extensions (SSE, NEON or wasm SIMD depending
+// on the target). Define ENEMY_KERNELS_SCALAR to build the scalar reference instead.
+#if defined(__GNUC__) && !defined(ENEMY_KERNELS_SCALAR)
+#define ENEMY_KERNELS_VECTOR
+#endif
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration (local)
+//------------------------------------------------------------------------------------
+static int GameRandom(GameState *state, int min, int max);
+static bool RecsOverlap(Rectangle a, Rectangle b);
+static void EmitEvent(GameState *state, GameEvent event);
+static void StageBegin(GameState *state, GameStage stage);
+static void StageEnd(GameState *state, GameStage stage);
+static void SavePreviousPositions(GameState *state);
+static void UpdateWave(GameState *state);
+static void BeginWaveSpawns(GameState *state);
+static void UpdateWaveSpawns(GameState *state, const WaveDesc *wave);
+static bool SpawnWaveEnemy(GameState *state, const WaveDesc *wave);
+static void UpdatePlayer(GameState *state, const GameInput *input);
+static void UpdateEnemies(GameState *state);
+static void UpdateShoots(GameState *state, const GameInput *input);
+static inline Rectangle EnemyRec(const EnemyStore *enemies, int i);
+static void ApproachEnemies(EnemyStore *enemies, float right, float bottom);
+static void ChaseEnemies(EnemyStore *enemies, Vector2 target);
+static void BuildEnemyGrid(GameState *state);
+static int QueryEnemyGrid(GameState *state, Rectangle area, int *result);
+static void ReserveEnemies(GameState *state, int capacity);
+static int SpawnEnemy(GameState *state, SpawnSide side, const EnemyKind *kind);
+static void ReleaseDeadEnemies(GameState *state);
+static Shoot *SpawnShoot(GameState *state);
+static void ReleaseDeadShoots(GameState *state);
+
+//------------------------------------------------------------------------------------
+// Initialize game variables
+//------------------------------------------------------------------------------------
+void GameInit(GameState *state, unsigned int seed, int screenWidth, int screenHeight)
+{
+    state->rngState = (seed != 0) ? seed : 0x9e3779b9u; // xorshift can't leave zero
+    state->screenWidth = screenWidth;
+    state->screenHeight = screenHeight;
+
+    // Secure that the game will start properly
+    state->alive = true;
+    state->damageAnim = false;
+    state->damageAnimCount = 0;
+    state->invencibleCount = 0;
+    state->colision = true;
+    state->lifeCount = 3;
+    state->timerCount = 0;
+
+    // Initialize game variables
+    state->shootRate = 0;
+    state->pause = false;
+    state->gameOver = false;
+    state->victory = false;
+    state->smooth = false;
+    if (state->waveTable == NULL)
+        state->waveTable = GetDefaultWaves();
+
+    state->wave = 0;
+    state->activeEnemies = state->waveTable->waves[0].count;
+    state->enemiesKill = 0;
+    state->score = 0;
+    state->alpha = 0;
+    state->frameCount = 0;
+
+    // Initialize player
+    Player *player = &state->player;
+
+    player->playerSrc = (Rectangle){0, 0, 16, 16};
+    player->playerDest = (Rectangle){screenWidth / 2, screenHeight / 2, 32, 32};
+    player->origin = (Vector2){player->playerDest.width / 2, player->playerDest.height / 2};
+    player->speed = (Vector2){4, 4};
+    player->prev = (Vector2){player->playerDest.x, player->playerDest.y};
+    player->sprite = PLAYER_WALK;
+
+    state->moving = false;
+    state->canWalkR = true;
+    state->canWalkL = true;
+    state->canWalkD = true;
+    state->canWalkU = true;
+    state->direction = 0;
+    state->dirImg = 0;
+    state->playerFrame = 0;
+
+    // Empty the pools, the first wave starts spawning on the first step. The enemy pool
+    // is warmed up for the largest wave here, so no wave change has to grow it.
+    int largestWave = NUM_MAX_ENEMIES;
+
+    for (int i = 0; i < state->waveTable->waveCount; i++)
+    {
+        if (state->waveTable->waves[i].count > largestWave)
+            largestWave = state->waveTable->waves[i].count;
+    }
+
+    ReserveEnemies(state, largestWave);
+    state->enemies.count = 0;
+    state->deadEnemies = 0;
+    state->shootCount = 0;
+    state->spawned = 0;
+    state->spawnTicks = 0;
+    state->load = true;
+}
+
+//------------------------------------------------------------------------------------
+// Update game (one tick)
+//------------------------------------------------------------------------------------
+void GameStep(GameState *state, const GameInput *input)
+{
+    state->screenWidth = input->screenWidth;
+    state->screenHeight = input->screenHeight;
+
+    // Time counter (60|1sec)
+    state->frameCount++;
+
+    SavePreviousPositions(state);
+
+    if (input->pausePressed)
+        state->pause = !state->pause;
+
+    if (!state->pause)
+    {
+        StageBegin(state, GAME_STAGE_WAVE);
+        UpdateWave(state);
+        StageEnd(state, GAME_STAGE_WAVE);
+
+        StageBegin(state, GAME_STAGE_PLAYER);
+        UpdatePlayer(state, input);
+        StageEnd(state, GAME_STAGE_PLAYER);
+
+        UpdateEnemies(state);
+
+        StageBegin(state, GAME_STAGE_SHOOTS);
+        UpdateShoots(state, input);
+        StageEnd(state, GAME_STAGE_SHOOTS);
+
+        // Compact the pools once nothing holds an index into them anymore
+        StageBegin(state, GAME_STAGE_RELEASE);
+        ReleaseDeadEnemies(state);
+        ReleaseDeadShoots(state);
+        StageEnd(state, GAME_STAGE_RELEASE);
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Unload game variables
+//------------------------------------------------------------------------------------
+void GameFree(GameState *state)
+{
+    EnemyStore *enemies = &state->enemies;
+
+    free(enemies->x);
+    free(enemies->y);
+    free(enemies->prevX);
+    free(enemies->prevY);
+    free(enemies->vx);
+    free(enemies->vy);
+    free(enemies->width);
+    free(enemies->height);
+    free(enemies->sepX);
+    free(enemies->sepY);
+    free(enemies->life);
+    free(enemies->flags);
+    free(enemies->side);
+    free(enemies->dir);
+    free(state->enemy);
+    free(state->gridNext);
+    free(state->gridQuery);
+    free(state->shoot);
+
+    state->enemies = (EnemyStore){0};
+    state->enemy = NULL;
+    state->gridNext = NULL;
+    state->gridQuery = NULL;
+    state->shoot = NULL;
+    state->shootCount = 0;
+    state->shootCapacity = 0;
+}
+
+Shoot *GameSpawnShoot(GameState *state, int direction)
+{
+    Shoot *shot = SpawnShoot(state);
+
+    if (shot != NULL)
+        shot->bulletDirection = direction;
+
+    return shot;
+}
+
+void GameFlushSpawns(GameState *state)
+{
+    if (state->load)
+        BeginWaveSpawns(state);
+
+    const WaveDesc *wave = &state->waveTable->waves[state->wave];
+
+    ReserveEnemies(state, state->enemies.count + state->activeEnemies - state->spawned);
+
+    while (state->spawned < state->activeEnemies)
+    {
+        if (!SpawnWaveEnemy(state, wave))
+            break;
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+// xorshift32, same [min, max] contract as raylib's GetRandomValue()
+static int GameRandom(GameState *state, int min, int max)
+{
+    if (min > max)
+    {
+        int tmp = max;
+        max = min;
+        min = tmp;
+    }
+
+    unsigned int x = state->rngState;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    state->rngState = x;
+
+    return (int)(x % (unsigned int)(max - min + 1)) + min;
+}
+
+// Same test as raylib's CheckCollisionRecs()
+static bool RecsOverlap(Rectangle a, Rectangle b)
+{
+    return (a.x < (b.x + b.width)) && ((a.x + a.width) > b.x) &&
+           (a.y < (b.y + b.height)) && ((a.y + a.height) > b.y);
+}
+
+static void EmitEvent(GameState *state, GameEvent event)
+{
+    if (state->hooks.onEvent != NULL)
+        state->hooks.onEvent(event, state->hooks.userData);
+}
+
+static void StageBegin(GameState *state, GameStage stage)
+{
+    if (state->hooks.onStage != NULL)
+        state->hooks.onStage(stage, true, state->hooks.userData);
+}
+
+static void StageEnd(GameState *state, GameStage stage)
+{
+    if (state->hooks.onStage != NULL)
+        state->hooks.onStage(stage, false, state->hooks.userData);
+}
+
+// Called at the start of every tick; the frontend blends from these
+// positions towards the current ones when drawing
+static void SavePreviousPositions(GameState *state)
+{
+    EnemyStore *enemies = &state->enemies;
+
+    state->player.prev = (Vector2){state->player.playerDest.x, state->player.playerDest.y};
+
+    memcpy(enemies->prevX, enemies->x, enemies->count * sizeof(float));
+    memcpy(enemies->prevY, enemies->y, enemies->count * sizeof(float));
+
+    for (int i = 0; i < state->shootCount; i++)
+        state->shoot[i].prev = (Vector2){state->shoot[i].rec.x, state->shoot[i].rec.y};
+}
+
+//------------------------------------------------------------------------------------
+// Waves
+//------------------------------------------------------------------------------------
+// One engine for every wave of the table: stream the enemies in, fade the title in and
+// out, and move to the next wave once all of them are killed
+static void UpdateWave(GameState *state)
+{
+    const WaveDesc *wave = &state->waveTable->waves[state->wave];
+
+    if (state->load)
+        BeginWaveSpawns(state);
+
+    UpdateWaveSpawns(state, wave);
+
+    if (!state->smooth)
+    {
+        state->alpha += 0.02f;
+
+        if (state->alpha >= 1.0f)
+            state->smooth = true;
+    }
+
+    if (state->smooth)
+        state->alpha -= 0.02f;
+
+    if (state->enemiesKill == state->activeEnemies)
+    {
+        state->enemiesKill = 0;
+
+        if (wave->victory)
+            state->victory = true;
+
+        state->wave = wave->next;
+        state->activeEnemies = state->waveTable->waves[wave->next].count;
+        state->smooth = false;
+        state->load = true;
+        state->alpha = 0.0f;
+    }
+}
+
+static void BeginWaveSpawns(GameState *state)
+{
+    state->spawned = 0;
+    state->spawnTicks = 0;
+    state->load = false;
+}
+
+// Stream the current wave into the pool along its spawn curve, never more than the
+// wave's budget in one tick, so a wave change costs about as much as any other tick
+static void UpdateWaveSpawns(GameState *state, const WaveDesc *wave)
+{
+    if (state->spawned >= state->activeEnemies)
+        return;
+
+    state->spawnTicks++;
+
+    int due = state->activeEnemies;
+
+    if (state->spawnTicks < wave->duration)
+        due = (int)ceilf(state->activeEnemies * powf((float)state->spawnTicks / wave->duration, wave->exponent));
+
+    if (due > state->spawned + wave->budget)
+        due = state->spawned + wave->budget;
+
+    while (state->spawned < due)
+    {
+        // A pool that can't grow holds the rest back, they are retried next tick
+        if (!SpawnWaveEnemy(state, wave))
+            break;
+    }
+}
+
+// Append the wave's next enemy as its compiled spawn order says. Sides rotate with the
+// spawn count, skipping the ones the kind doesn't come from.
+static bool SpawnWaveEnemy(GameState *state, const WaveDesc *wave)
+{
+    const WaveTable *table = state->waveTable;
+    const EnemyKind *kind = &table->kinds[table->spawns[wave->firstSpawn + state->spawned % wave->patternLength]];
+    int side = state->spawned % 4;
+
+    while (!(kind->sides & (1 << side)))
+        side = (side + 1) % 4;
+
+    if (SpawnEnemy(state, side, kind) < 0)
+        return false;
+
+    state->spawned++;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------
+// Player
+//------------------------------------------------------------------------------------
+static void UpdatePlayer(GameState *state, const GameInput *input)
+{
+    Player *player = &state->player;
+    EnemyStore *enemies = &state->enemies;
+
+    // Player movement
+    state->moving = false;
+
+    if (state->alive)
+    {
+        if (input->up && input->left)
+        {
+            if (state->canWalkU && state->canWalkL)
+            {
+                player->playerDest.x -= player->speed.x;
+                player->playerDest.y -= player->speed.y;
+            }
+
+            state->direction = 7;
+            state->dirImg = 1;
+            state->moving = true;
+        }
+
+        else if (input->up && input->right)
+        {
+            if (state->canWalkU && state->canWalkR)
+            {
+                player->playerDest.x += player->speed.x;
+                player->playerDest.y -= player->speed.y;
+            }
+            state->direction = 6;
+            state->dirImg = 1;
+            state->moving = true;
+        }
+
+        else if (input->down && input->left)
+        {
+            if (state->canWalkD && state->canWalkL)
+            {
+                player->playerDest.x -= player->speed.x;
+                player->playerDest.y += player->speed.y;
+            }
+            state->direction = 5;
+            state->dirImg = 0;
+            state->moving = true;
+        }
+
+        else if (input->down && input->right)
+        {
+            if (state->canWalkD && state->canWalkR)
+            {
+                player->playerDest.x += player->speed.x;
+                player->playerDest.y += player->speed.y;
+            }
+            state->direction = 4;
+            state->dirImg = 0;
+            state->moving = true;
+        }
+
+        else if (input->right)
+        {
+            if (state->canWalkR)
+                player->playerDest.x += player->speed.x;
+
+            state->direction = 3;
+            state->dirImg = 3;
+            state->moving = true;
+        }
+
+        else if (input->left)
+        {
+            if (state->canWalkL)
+                player->playerDest.x -= player->speed.x;
+
+            state->direction = 2;
+            state->dirImg = 2;
+            state->moving = true;
+        }
+
+        else if (input->up)
+        {
+            if (state->canWalkU)
+                player->playerDest.y -= player->speed.y;
+
+            state->direction = 1;
+            state->dirImg = 1;
+            state->moving = true;
+        }
+
+        else if (input->down)
+        {
+            if (state->canWalkD)
+                player->playerDest.y += player->speed.y;
+
+            state->direction = 0;
+            state->dirImg = 0;
+            state->moving = true;
+        }
+    }
+
+    /*
+    Vector2 p;
+    Vector2 q;
+
+    switch (direction)
+    {
+        case 0:
+            p.x = player.playerDest.x;
+            p.y = player.playerDest.y + player.playerDest.height/2 + 10;
+            break;
+
+        case 1:
+            p.x = player.playerDest.x;
+            p.y = player.playerDest.y - player.playerDest.height/2 - 10;
+            break;
+
+        case 2:
+            p.x = player.playerDest.x - player.playerDest.width/2 - 10;
+            p.y = player.playerDest.y;
+            break;
+
+        case 3:
+            p.x = player.playerDest.x + player.playerDest.width/2 + 10;
+            p.y = player.playerDest.y;
+            break;
+
+        case 4:
+            p.x = player.playerDest.x + player.playerDest.width/2 + 10;
+            p.y = player.playerDest.y + player.playerDest.height/2 + 10;
+            q.x = player.playerDest.x;
+            q.y = player.playerDest.y + player.playerDest.height/2 + 10;
+            break;
+
+        case 5:
+            p.x = player.playerDest.x - player.playerDest.width/2 - 10;
+            p.y = player.playerDest.y + player.playerDest.height/2 + 10;
+            q.x = player.playerDest.x;
+            q.y = player.playerDest.y + player.playerDest.height/2 + 10;
+            break;
+
+        case 6:
+            p.x = player.playerDest.x + player.playerDest.width/2 + 10;
+            p.y = player.playerDest.y - player.playerDest.height/2 - 10;
+            q.x = player.playerDest.x;
+            q.y = player.playerDest.y - player.playerDest.height/2 - 10;
+            break;
+
+        case 7:
+            p.x = player.playerDest.x - player.playerDest.width/2 - 10;
+            p.y = player.playerDest.y - player.playerDest.height/2 - 10;
+            q.x = player.playerDest.x;
+            q.y = player.playerDest.y - player.playerDest.height/2 - 10;
+            break;
+
+        default: break;
+    }
+
+    // Map collision behaviour
+    if (CheckCollisionPointRec(p, statue) || CheckCollisionPointRec(q, statue))
+    {
+        switch (direction)
+        {
+            case 0:
+            case 4:
+            case 5: canWalkD = false;
+                    canWalkU = true;
+                    canWalkL = true;
+                    canWalkR = true;
+                    break;
+
+            case 1:
+            case 6:
+            case 7: canWalkU = false;
+                    canWalkD = true;
+                    canWalkL = true;
+                    canWalkR = true;
+                    break;
+
+            case 2: canWalkL = false;
+                    canWalkD = true;
+                    canWalkU = true;
+                    canWalkR = true;
+                    break;
+
+            case 3: canWalkR = false;
+                    canWalkD = true;
+                    canWalkU = true;
+                    canWalkL = true;
+                    break;
+
+            default: break;
+        }
+    }
+    else
+    {
+        canWalkD = true;
+        canWalkU = true;
+        canWalkL = true;
+        canWalkR = true;
+    }
+    */
+
+    // In case the player is moving diagonaly and stop, shoot won't bug
+    if (!state->moving)
+    {
+        if (state->direction == 4 || state->direction == 5)
+            state->direction = 0;
+
+        if (state->direction == 6 || state->direction == 7)
+            state->direction = 1;
+    }
+
+    // Player's movement animation
+    player->playerSrc.y = 0;
+
+    if (state->moving)
+    {
+        if (state->frameCount % 10 == 1)
+            state->playerFrame++;
+
+        player->playerSrc.y = player->playerSrc.width * state->playerFrame;
+    }
+
+    // Reset the animation
+    if (state->playerFrame > 3)
+        state->playerFrame = 0;
+
+    player->playerSrc.x = player->playerSrc.width * state->dirImg;
+
+    // Player collision with enemy
+    if (state->alive && state->colision)
+    {
+        StageBegin(state, GAME_STAGE_COLLISION);
+
+        for (int i = 0; i < enemies->count; i++)
+        {
+            if ((enemies->flags[i] & ENEMY_ACTIVE) && RecsOverlap(player->playerDest, EnemyRec(enemies, i)))
+            {
+                EmitEvent(state, GAME_EVENT_PLAYER_HIT);
+                state->lifeCount--;
+                state->colision = false;
+                state->damageAnim = true;
+                state->damageAnimCount = 0;
+                state->invencibleCount = 0;
+                break;
+            }
+        }
+
+        StageEnd(state, GAME_STAGE_COLLISION);
+    }
+
+    if (state->alive)
+    {
+        // Damage "animation" indicator
+        if (state->damageAnim)
+        {
+            if (state->damageAnimCount == 0 || state->damageAnimCount == 200)
+            {
+                player->sprite = PLAYER_DAMAGE;
+            }
+            else if (state->damageAnimCount == 100 || state->damageAnimCount == 300)
+            {
+                player->sprite = PLAYER_WALK;
+            }
+
+            state->damageAnimCount++;
+
+            if (state->damageAnimCount > 300)
+            {
+                state->damageAnim = false;
+                state->damageAnimCount = 0;
+            }
+        }
+
+        // Player can't take damage while "invencible" is activated
+        state->invencibleCount++;
+        if (state->invencibleCount > 300)
+        {
+            state->colision = true;
+        }
+    }
+
+    // When player is dead
+    if (state->lifeCount == 0)
+    {
+        if (state->alive)
+        {
+            EmitEvent(state, GAME_EVENT_PLAYER_DEAD);
+            state->alive = false;
+        }
+
+        player->sprite = PLAYER_DEAD;
+        player->playerSrc.x = 0;
+        player->playerSrc.y = 0;
+
+        state->timerCount++;
+
+        if (state->timerCount > 500)
+        {
+            state->gameOver = true;
+        }
+    }
+
+    // Wall behaviour
+    if (player->playerDest.x - player->playerDest.width / 2 <= 0)
+        player->playerDest.x = player->playerDest.width / 2;
+    if (player->playerDest.x + player->playerDest.width / 2 >= state->screenWidth)
+        player->playerDest.x = state->screenWidth - player->playerDest.width / 2;
+    if (player->playerDest.y - player->playerDest.height / 2 <= 0)
+        player->playerDest.y = player->playerDest.height / 2;
+    if (player->playerDest.y + player->playerDest.height / 2 >= state->screenHeight)
+        player->playerDest.y = state->screenHeight - player->playerDest.height / 2;
+}
+
+//------------------------------------------------------------------------------------
+// Enemies
+//------------------------------------------------------------------------------------
+static void UpdateEnemies(GameState *state)
+{
+    Player *player = &state->player;
+    EnemyStore *enemies = &state->enemies;
+
+    // Initial enemy behaviour (walk in from the spawn side until inside the screen)
+    StageBegin(state, GAME_STAGE_APPROACH);
+    ApproachEnemies(enemies, state->screenWidth - 25, state->screenHeight - 25);
+    StageEnd(state, GAME_STAGE_APPROACH);
+
+    StageBegin(state, GAME_STAGE_SEPARATION);
+
+    // Enemy spatial index, built once per frame and shared by the separation
+    // step and the shuriken hit tests below
+    BuildEnemyGrid(state);
+
+    // Enemy separation: flag every enemy overlapping another one and remember
+    // where that neighbour stands, so the enemy steps away from it this frame
+    for (int i = 0; i < enemies->count; i++)
+    {
+        enemies->flags[i] &= ~ENEMY_COLLIDED;
+
+        // Enemies still walking in from the spawn margin only approach, nothing reads
+        // their separation. They stay in the grid so the others still avoid them.
+        if (!(enemies->flags[i] & ENEMY_FREE))
+            continue;
+
+        // Only enemies in the neighbouring cells can overlap this one. The highest
+        // overlapping index wins, as when the whole store was scanned in order.
+        int neighbours = QueryEnemyGrid(state, EnemyRec(enemies, i), state->gridQuery);
+        int nearest = -1;
+
+        for (int k = 0; k < neighbours; k++)
+        {
+            int j = state->gridQuery[k];
+
+            if (i != j && j > nearest && RecsOverlap(EnemyRec(enemies, i), EnemyRec(enemies, j)))
+                nearest = j;
+        }
+
+        if (nearest >= 0)
+        {
+            enemies->flags[i] |= ENEMY_COLLIDED;
+            enemies->sepX[i] = enemies->x[nearest];
+            enemies->sepY[i] = enemies->y[nearest];
+        }
+    }
+
+    StageEnd(state, GAME_STAGE_SEPARATION);
+
+    // General enemy behaviour (follow player)
+    StageBegin(state, GAME_STAGE_CHASE);
+    ChaseEnemies(enemies, (Vector2){player->playerDest.x, player->playerDest.y});
+    StageEnd(state, GAME_STAGE_CHASE);
+
+    // Enemy movement animation
+    StageBegin(state, GAME_STAGE_ANIMATION);
+
+    for (int i = 0; i < enemies->count; i++)
+    {
+        state->enemy[i].enemySrc.y = 0;
+
+        if (enemies->flags[i] & ENEMY_ACTIVE)
+        {
+            if (state->frameCount % 10 == 1)
+                state->enemy[i].enemyFrame++;
+
+            state->enemy[i].enemySrc.y = state->enemy[i].enemySrc.height * state->enemy[i].enemyFrame;
+        }
+
+        // Reset the animation
+        if (state->enemy[i].enemyFrame > 3)
+            state->enemy[i].enemyFrame = 0;
+
+        state->enemy[i].enemySrc.x = state->enemy[i].enemySrc.width * enemies->dir[i];
+    }
+
+    StageEnd(state, GAME_STAGE_ANIMATION);
+}
+
+//------------------------------------------------------------------------------------
+// Shurikens
+//------------------------------------------------------------------------------------
+static void UpdateShoots(GameState *state, const GameInput *input)
+{
+    Player *player = &state->player;
+    EnemyStore *enemies = &state->enemies;
+
+    // Shoot initialization
+    if (input->fire)
+    {
+        state->shootRate += 2;
+
+        if (state->shootRate % 40 == 0)
+        {
+            Shoot *shot = SpawnShoot(state);
+
+            if (shot != NULL)
+            {
+                shot->rec.x = player->playerDest.x;
+                shot->rec.y = player->playerDest.y + 10;
+                shot->prev = (Vector2){shot->rec.x, shot->rec.y};
+
+                // Bullet Movement
+                // Using variable direction to see where's the player shooting.
+                // Using bulletDirection to define where's the bullet going.
+                shot->bulletDirection = state->direction;
+            }
+        }
+    }
+
+    // Shoot logic
+    for (int i = 0; i < state->shootCount; i++)
+    {
+        if (state->shoot[i].active)
+        {
+            // Shuriken throw animation
+            if (state->frameCount % 4 == 0)
+            {
+                state->shoot[i].shootSrc.x = state->shoot[i].bulletFrame * 16;
+                state->shoot[i].bulletFrame++;
+
+                if (state->shoot[i].bulletFrame > 1)
+                    state->shoot[i].bulletFrame = 0;
+            }
+
+            // bulletDirection:
+            switch (state->shoot[i].bulletDirection)
+            {
+            // [Top-Left]
+            case 7:
+                state->shoot[i].rec.x -= state->shoot[i].speed.x;
+                state->shoot[i].rec.y -= state->shoot[i].speed.y;
+                break;
+
+            // [Top-Right]
+            case 6:
+                state->shoot[i].rec.x += state->shoot[i].speed.x;
+                state->shoot[i].rec.y -= state->shoot[i].speed.y;
+                break;
+
+            // [Bottom-Left]
+            case 5:
+                state->shoot[i].rec.x -= state->shoot[i].speed.x;
+                state->shoot[i].rec.y += state->shoot[i].speed.y;
+                break;
+
+            // [Bottom-Right]
+            case 4:
+                state->shoot[i].rec.x += state->shoot[i].speed.x;
+                state->shoot[i].rec.y += state->shoot[i].speed.y;
+                break;
+
+            // [Right]
+            case 3:
+                state->shoot[i].rec.x += state->shoot[i].speed.x;
+                break;
+
+            // [Left]
+            case 2:
+                state->shoot[i].rec.x -= state->shoot[i].speed.x;
+                break;
+
+            // [Top]
+            case 1:
+                state->shoot[i].rec.y -= state->shoot[i].speed.y;
+                break;
+
+            // [Bottom]
+            case 0:
+                state->shoot[i].rec.y += state->shoot[i].speed.y;
+                break;
+
+            default:
+                break;
+            }
+        }
+    }
+
+    // Collision with enemy, only against the enemies the grid puts near each shuriken.
+    // Every overlapping enemy takes the hit, so the order they come in doesn't matter.
+    // One pass over all of them, so the stage hook brackets it once per tick.
+    StageBegin(state, GAME_STAGE_COLLISION);
+
+    for (int i = 0; i < state->shootCount; i++)
+    {
+        if (state->shoot[i].active)
+        {
+            int candidates = QueryEnemyGrid(state, state->shoot[i].rec, state->gridQuery);
+
+            for (int k = 0; k < candidates; k++)
+            {
+                int j = state->gridQuery[k];
+
+                if (enemies->flags[j] & ENEMY_ACTIVE)
+                {
+                    if (RecsOverlap(state->shoot[i].rec, EnemyRec(enemies, j)))
+                    {
+                        EmitEvent(state, GAME_EVENT_ENEMY_HIT);
+                        state->shoot[i].active = false;
+                        enemies->life[j]--;
+
+                        if (enemies->life[j] == 0)
+                        {
+                            // Released at the end of the frame, so indices stay valid until then
+                            enemies->flags[j] &= ~ENEMY_ACTIVE;
+                            state->deadEnemies++;
+
+                            state->enemiesKill++;
+                            state->score += 100;
+                        }
+                        // shootRate = 0;
+                    }
+                }
+            }
+        }
+    }
+
+    StageEnd(state, GAME_STAGE_COLLISION);
+
+    for (int i = 0; i < state->shootCount; i++)
+    {
+        if (state->shoot[i].active)
+        {
+            // Off-screen culling
+            if (state->shoot[i].rec.x >= state->screenWidth)
+            {
+                state->shoot[i].active = false;
+                // shootRate = 0;
+            }
+
+            if (state->shoot[i].rec.x < -state->shoot[i].rec.width)
+            {
+                state->shoot[i].active = false;
+                // shootRate = 0;
+            }
+
+            if (state->shoot[i].rec.y < -state->shoot[i].rec.height)
+            {
+                state->shoot[i].active = false;
+                // shootRate = 0;
+            }
+
+            if (state->shoot[i].rec.y >= state->screenHeight)
+            {
+                state->shoot[i].active = false;
+                // shootRate = 0;
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Enemy spatial hash
+//------------------------------------------------------------------------------------
+// Uniform grid hashed into a fixed bucket table, so the world (including the spawn
+// margin outside the screen) does not need to be bounded. Each bucket is a linked
+// list threaded through gridNext, holding every enemy in the store.
+static int GridBucket(int cellX, int cellY)
+{
+    return (int)(((unsigned int)cellX * 73856093u ^ (unsigned int)cellY * 19349663u) & (GRID_BUCKETS - 1));
+}
+
+static void BuildEnemyGrid(GameState *state)
+{
+    EnemyStore *enemies = &state->enemies;
+
+    for (int i = 0; i < GRID_BUCKETS; i++)
+        state->gridHead[i] = -1;
+
+    // Inserted backwards so every bucket lists its enemies in ascending order
+    for (int i = enemies->count - 1; i >= 0; i--)
+    {
+        int bucket = GridBucket((int)floorf(enemies->x[i] / GRID_CELL_SIZE), (int)floorf(enemies->y[i] / GRID_CELL_SIZE));
+
+        state->gridNext[i] = state->gridHead[bucket];
+        state->gridHead[bucket] = i;
+    }
+}
+
+// Collect every enemy that may overlap the area, in no particular order across buckets.
+// Returns the number of indices written to result (at most enemies.count).
+static int QueryEnemyGrid(GameState *state, Rectangle area, int *result)
+{
+    int minX = (int)floorf((area.x - GRID_QUERY_MARGIN) / GRID_CELL_SIZE);
+    int maxX = (int)floorf((area.x + area.width + GRID_QUERY_MARGIN) / GRID_CELL_SIZE);
+    int minY = (int)floorf((area.y - GRID_QUERY_MARGIN) / GRID_CELL_SIZE);
+    int maxY = (int)floorf((area.y + area.height + GRID_QUERY_MARGIN) / GRID_CELL_SIZE);
+    int count = 0;
+
+    // Stamps wrap around, start over from a clean table when they do
+    if (++state->gridStamp == 0)
+    {
+        memset(state->gridVisited, 0, sizeof(state->gridVisited));
+        state->gridStamp = 1;
+    }
+
+    for (int cellY = minY; cellY <= maxY; cellY++)
+    {
+        for (int cellX = minX; cellX <= maxX; cellX++)
+        {
+            int bucket = GridBucket(cellX, cellY);
+
+            // Two cells of the area can hash to the same bucket, walk it only once
+            if (state->gridVisited[bucket] == state->gridStamp)
+                continue;
+
+            state->gridVisited[bucket] = state->gridStamp;
+
+            for (int i = state->gridHead[bucket]; i != -1; i = state->gridNext[i])
+                result[count++] = i;
+        }
+    }
+
+    return count;
+}
+
+//------------------------------------------------------------------------------------
+// Entity pools
+//------------------------------------------------------------------------------------
+// Enemies and shurikens live in dense, heap allocated pools. Removal swaps the last
+// live entry into the freed slot, so the tail of each pool doubles as its free list
+// and every loop only walks live entries.
+static bool GrowArray(void **array, int capacity, size_t size)
+{
+    void *grown = realloc(*array, (size_t)capacity * size);
+
+    if (grown == NULL)
+        return false;
+
+    *array = grown;
+    return true;
+}
+
+// Make room for at least capacity enemies; never shrinks
+static void ReserveEnemies(GameState *state, int capacity)
+{
+    EnemyStore *enemies = &state->enemies;
+
+    if (capacity <= enemies->capacity)
+        return;
+
+    int grown = (enemies->capacity > 0) ? enemies->capacity * 2 : 4;
+
+    while (grown < capacity)
+        grown *= 2;
+
+    grown = (grown + 3) & ~3; // Whole blocks of four for the movement kernels
+
+    bool ok = GrowArray((void **)&enemies->x, grown, sizeof(float)) &&
+              GrowArray((void **)&enemies->y, grown, sizeof(float)) &&
+              GrowArray((void **)&enemies->prevX, grown, sizeof(float)) &&
+              GrowArray((void **)&enemies->prevY, grown, sizeof(float)) &&
+              GrowArray((void **)&enemies->vx, grown, sizeof(float)) &&
+              GrowArray((void **)&enemies->vy, grown, sizeof(float)) &&
+              GrowArray((void **)&enemies->width, grown, sizeof(float)) &&
+              GrowArray((void **)&enemies->height, grown, sizeof(float)) &&
+              GrowArray((void **)&enemies->sepX, grown, sizeof(float)) &&
+              GrowArray((void **)&enemies->sepY, grown, sizeof(float)) &&
+              GrowArray((void **)&enemies->life, grown, sizeof(int)) &&
+              GrowArray((void **)&enemies->flags, grown, sizeof(int)) &&
+              GrowArray((void **)&enemies->side, grown, sizeof(int)) &&
+              GrowArray((void **)&enemies->dir, grown, sizeof(int)) &&
+              GrowArray((void **)&state->enemy, grown, sizeof(Enemy)) &&
+              GrowArray((void **)&state->gridNext, grown, sizeof(int)) &&
+              GrowArray((void **)&state->gridQuery, grown, sizeof(int));
+
+    // Arrays that did grow are just larger than needed, the old capacity stays valid
+    if (ok)
+        enemies->capacity = grown;
+}
+
+// Append an enemy of the given kind just outside the screen on the given side,
+// returns its index or -1
+static int SpawnEnemy(GameState *state, SpawnSide side, const EnemyKind *kind)
+{
+    EnemyStore *enemies = &state->enemies;
+
+    if (enemies->count == enemies->capacity)
+        ReserveEnemies(state, enemies->count + 1);
+
+    if (enemies->count == enemies->capacity)
+        return -1;
+
+    int i = enemies->count++;
+
+    enemies->width[i] = kind->size;
+    enemies->height[i] = kind->size;
+    enemies->vx[i] = kind->speed;
+    enemies->vy[i] = kind->speed;
+    enemies->sepX[i] = 0;
+    enemies->sepY[i] = 0;
+    enemies->life[i] = kind->life;
+    enemies->flags[i] = ENEMY_ACTIVE;
+    enemies->side[i] = side;
+    enemies->dir[i] = 0;
+
+    switch (side)
+    {
+    case SIDE_RIGHT:
+        enemies->x[i] = GameRandom(state, state->screenWidth, state->screenWidth + 1000);
+        enemies->y[i] = GameRandom(state, 0, state->screenHeight - enemies->height[i]);
+        break;
+
+    case SIDE_LEFT:
+        enemies->x[i] = GameRandom(state, -1000, 0);
+        enemies->y[i] = GameRandom(state, 0, state->screenHeight - enemies->height[i]);
+        break;
+
+    case SIDE_BOTTOM:
+        enemies->x[i] = GameRandom(state, 0, state->screenWidth - enemies->width[i]);
+        enemies->y[i] = GameRandom(state, state->screenHeight, state->screenHeight + 1000);
+        break;
+
+    case SIDE_TOP:
+        enemies->x[i] = GameRandom(state, 0, state->screenWidth - enemies->width[i]);
+        enemies->y[i] = GameRandom(state, -1000, 0);
+        break;
+
+    default:
+        break;
+    }
+
+    enemies->prevX[i] = enemies->x[i];
+    enemies->prevY[i] = enemies->y[i];
+
+    state->enemy[i].enemyFrame = 0;
+    state->enemy[i].type = kind->type;
+    state->enemy[i].enemySrc = (Rectangle){0, 0, 16, 16};
+    state->enemy[i].origin = (Vector2){enemies->width[i] / 2, enemies->height[i] / 2};
+    state->enemy[i].enemySprite = kind->sprite;
+
+    return i;
+}
+
+// Swap-remove every enemy killed this frame
+static void ReleaseDeadEnemies(GameState *state)
+{
+    EnemyStore *enemies = &state->enemies;
+
+    if (state->deadEnemies == 0)
+        return;
+
+    int i = 0;
+
+    while (i < enemies->count)
+    {
+        if (enemies->flags[i] & ENEMY_ACTIVE)
+        {
+            i++;
+            continue;
+        }
+
+        int last = --enemies->count;
+
+        if (i != last)
+        {
+            enemies->x[i] = enemies->x[last];
+            enemies->y[i] = enemies->y[last];
+            enemies->prevX[i] = enemies->prevX[last];
+            enemies->prevY[i] = enemies->prevY[last];
+            enemies->vx[i] = enemies->vx[last];
+            enemies->vy[i] = enemies->vy[last];
+            enemies->width[i] = enemies->width[last];
+            enemies->height[i] = enemies->height[last];
+            enemies->sepX[i] = enemies->sepX[last];
+            enemies->sepY[i] = enemies->sepY[last];
+            enemies->life[i] = enemies->life[last];
+            enemies->flags[i] = enemies->flags[last];
+            enemies->side[i] = enemies->side[last];
+            enemies->dir[i] = enemies->dir[last];
+            state->enemy[i] = state->enemy[last];
+        }
+    }
+
+    state->deadEnemies = 0;
+}
+
+// Append an active shuriken, returns NULL only if the pool can't grow
+static Shoot *SpawnShoot(GameState *state)
+{
+    if (state->shootCount == state->shootCapacity)
+    {
+        int grown = (state->shootCapacity > 0) ? state->shootCapacity * 2 : NUM_SHOOTS;
+
+        if (!GrowArray((void **)&state->shoot, grown, sizeof(Shoot)))
+            return NULL;
+
+        state->shootCapacity = grown;
+    }
+
+    Shoot *shot = &state->shoot[state->shootCount++];
+
+    shot->active = true;
+    shot->bulletDirection = 0;
+    shot->bulletFrame = 0;
+    shot->shootSrc = (Rectangle){0, 0, 16, 16};
+    shot->rec = (Rectangle){state->player.playerDest.x, state->player.playerDest.y, 16, 16};
+    shot->origin = (Vector2){shot->rec.width / 2, shot->rec.height / 2};
+    shot->speed = (Vector2){7, 7};
+    shot->prev = (Vector2){shot->rec.x, shot->rec.y};
+
+    return shot;
+}
+
+// Swap-remove every shuriken that hit something or left the screen
+static void ReleaseDeadShoots(GameState *state)
+{
+    int i = 0;
+
+    while (i < state->shootCount)
+    {
+        if (state->shoot[i].active)
+            i++;
+        else
+            state->shoot[i] = state->shoot[--state->shootCount];
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Enemy movement kernels
+//------------------------------------------------------------------------------------
+// Each kernel has a scalar reference and a four-lane vector version. The vector code
+// only uses compares, selects, adds and subtracts, evaluated in the same order as the
+// scalar code, so both produce bit-identical positions, flags and directions.
+static inline Rectangle EnemyRec(const EnemyStore *enemies, int i)
+{
+    return (Rectangle){enemies->x[i], enemies->y[i], enemies->width[i], enemies->height[i]};
+}
+
+static void ApproachEnemiesScalar(EnemyStore *enemies, int begin, int end, float right, float bottom)
+{
+    for (int i = begin; i < end; i++)
+    {
+        if (!(enemies->flags[i] & ENEMY_ACTIVE))
+            continue;
+
+        switch (enemies->side[i])
+        {
+        case SIDE_RIGHT:
+            if (enemies->x[i] > right)
+                enemies->x[i] -= enemies->vx[i];
+            if (enemies->x[i] <= right)
+                enemies->flags[i] |= ENEMY_FREE;
+            break;
+
+        case SIDE_LEFT:
+            if (enemies->x[i] < 25)
+                enemies->x[i] += enemies->vx[i];
+            if (enemies->x[i] >= 25)
+                enemies->flags[i] |= ENEMY_FREE;
+            break;
+
+        case SIDE_BOTTOM:
+            if (enemies->y[i] > bottom)
+                enemies->y[i] -= enemies->vy[i];
+            if (enemies->y[i] <= bottom)
+                enemies->flags[i] |= ENEMY_FREE;
+            break;
+
+        case SIDE_TOP:
+            if (enemies->y[i] < 25)
+                enemies->y[i] += enemies->vy[i];
+            if (enemies->y[i] >= 25)
+                enemies->flags[i] |= ENEMY_FREE;
+            break;
+
+        default:
+            break;
+        }
+    }
+}
+
+static void ChaseEnemiesScalar(EnemyStore *enemies, int begin, int end, Vector2 target)
+{
+    for (int i = begin; i < end; i++)
+    {
+        int flags = enemies->flags[i];
+
+        if (!(flags & ENEMY_ACTIVE) || !(flags & ENEMY_FREE))
+            continue;
+
+        if (!(flags & ENEMY_COLLIDED))
+        {
+            bool yMenor = true;
+            bool yMaior = true;
+
+            if (target.x < enemies->x[i])
+                enemies->x[i] -= enemies->vx[i];
+
+            if (target.x > enemies->x[i])
+                enemies->x[i] += enemies->vx[i];
+
+            if (target.y < enemies->y[i])
+            {
+                enemies->y[i] -= enemies->vy[i];
+                enemies->dir[i] = 1; // Top
+            }
+            else
+                yMenor = false;
+
+            if (target.y > enemies->y[i])
+            {
+                enemies->y[i] += enemies->vy[i];
+                enemies->dir[i] = 0; // Bottom
+            }
+            else
+                yMaior = false;
+
+            // For horizonatal animation
+            if (!yMenor && !yMaior)
+            {
+                if (target.x < enemies->x[i])
+                    enemies->dir[i] = 2; // Left
+
+                if (target.x > enemies->x[i])
+                    enemies->dir[i] = 3; // Right
+            }
+        }
+        else
+        {
+            // Step away from the enemy it is overlapping
+            if (enemies->x[i] < enemies->sepX[i])
+                enemies->x[i] -= enemies->vx[i];
+
+            if (enemies->x[i] > enemies->sepX[i])
+                enemies->x[i] += enemies->vx[i];
+
+            if (enemies->y[i] < enemies->sepY[i])
+                enemies->y[i] -= enemies->vy[i];
+
+            if (enemies->y[i] > enemies->sepY[i])
+                enemies->y[i] += enemies->vy[i];
+        }
+    }
+}
+
+#if defined(ENEMY_KERNELS_VECTOR)
+typedef float Vec4f __attribute__((vector_size(16)));
+typedef int Vec4i __attribute__((vector_size(16)));
+
+static inline Vec4f SplatF(float value) { return (Vec4f){value, value, value, value}; }
+static inline Vec4i SplatI(int value) { return (Vec4i){value, value, value, value}; }
+
+// The pools come from malloc, so lanes are loaded and stored unaligned
+static inline Vec4f LoadF(const float *p) { Vec4f v; memcpy(&v, p, sizeof(v)); return v; }
+static inline Vec4i LoadI(const int *p) { Vec4i v; memcpy(&v, p, sizeof(v)); return v; }
+static inline void StoreF(float *p, Vec4f v) { memcpy(p, &v, sizeof(v)); }
+static inline void StoreI(int *p, Vec4i v) { memcpy(p, &v, sizeof(v)); }
+
+// Per lane: mask ? a : b (masks are all ones or all zeros, as produced by vector compares)
+static inline Vec4f SelectF(Vec4i mask, Vec4f a, Vec4f b) { return (Vec4f)(((Vec4i)a & mask) | ((Vec4i)b & ~mask)); }
+static inline Vec4i SelectI(Vec4i mask, Vec4i a, Vec4i b) { return (a & mask) | (b & ~mask); }
+
+static void ApproachEnemiesVector(EnemyStore *enemies, int begin, int end, float right, float bottom)
+{
+    const Vec4f vRight = SplatF(right);
+    const Vec4f vBottom = SplatF(bottom);
+    const Vec4f vNear = SplatF(25);
+
+    for (int i = begin; i < end; i += 4)
+    {
+        Vec4f x = LoadF(&enemies->x[i]);
+        Vec4f y = LoadF(&enemies->y[i]);
+        Vec4f vx = LoadF(&enemies->vx[i]);
+        Vec4f vy = LoadF(&enemies->vy[i]);
+        Vec4i flags = LoadI(&enemies->flags[i]);
+        Vec4i side = LoadI(&enemies->side[i]);
+        Vec4i active = (flags & ENEMY_ACTIVE) != SplatI(0);
+
+        Vec4i lane = active & (side == SplatI(SIDE_RIGHT));
+        x = SelectF(lane & (x > vRight), x - vx, x);
+        Vec4i freed = lane & (x <= vRight);
+
+        lane = active & (side == SplatI(SIDE_LEFT));
+        x = SelectF(lane & (x < vNear), x + vx, x);
+        freed |= lane & (x >= vNear);
+
+        lane = active & (side == SplatI(SIDE_BOTTOM));
+        y = SelectF(lane & (y > vBottom), y - vy, y);
+        freed |= lane & (y <= vBottom);
+
+        lane = active & (side == SplatI(SIDE_TOP));
+        y = SelectF(lane & (y < vNear), y + vy, y);
+        freed |= lane & (y >= vNear);
+
+        StoreF(&enemies->x[i], x);
+        StoreF(&enemies->y[i], y);
+        StoreI(&enemies->flags[i], flags | (freed & ENEMY_FREE));
+    }
+}
+
+static void ChaseEnemiesVector(EnemyStore *enemies, int begin, int end, Vector2 target)
+{
+    const Vec4f tx = SplatF(target.x);
+    const Vec4f ty = SplatF(target.y);
+
+    for (int i = begin; i < end; i += 4)
+    {
+        Vec4f x = LoadF(&enemies->x[i]);
+        Vec4f y = LoadF(&enemies->y[i]);
+        Vec4f vx = LoadF(&enemies->vx[i]);
+        Vec4f vy = LoadF(&enemies->vy[i]);
+        Vec4f sepX = LoadF(&enemies->sepX[i]);
+        Vec4f sepY = LoadF(&enemies->sepY[i]);
+        Vec4i flags = LoadI(&enemies->flags[i]);
+        Vec4i dir = LoadI(&enemies->dir[i]);
+
+        Vec4i moving = ((flags & ENEMY_ACTIVE) != SplatI(0)) & ((flags & ENEMY_FREE) != SplatI(0));
+        Vec4i collided = (flags & ENEMY_COLLIDED) != SplatI(0);
+        Vec4i chase = moving & ~collided;
+        Vec4i flee = moving & collided;
+
+        // Follow the target
+        x = SelectF(chase & (tx < x), x - vx, x);
+        x = SelectF(chase & (tx > x), x + vx, x);
+
+        Vec4i up = chase & (ty < y);
+        y = SelectF(up, y - vy, y);
+        dir = SelectI(up, SplatI(1), dir);
+
+        Vec4i down = chase & (ty > y);
+        y = SelectF(down, y + vy, y);
+        dir = SelectI(down, SplatI(0), dir);
+
+        Vec4i horizontal = chase & ~up & ~down;
+        dir = SelectI(horizontal & (tx < x), SplatI(2), dir);
+        dir = SelectI(horizontal & (tx > x), SplatI(3), dir);
+
+        // Step away from the overlapped enemy
+        x = SelectF(flee & (x < sepX), x - vx, x);
+        x = SelectF(flee & (x > sepX), x + vx, x);
+        y = SelectF(flee & (y < sepY), y - vy, y);
+        y = SelectF(flee & (y > sepY), y + vy, y);
+
+        StoreF(&enemies->x[i], x);
+        StoreF(&enemies->y[i], y);
+        StoreI(&enemies->dir[i], dir);
+    }
+}
+#endif
+
+// Walk every active enemy in from its spawn side until it crosses into the screen
+static void ApproachEnemies(EnemyStore *enemies, float right, float bottom)
+{
+    int count = enemies->count;
+
+#if defined(ENEMY_KERNELS_VECTOR)
+    int blocks = count & ~3;
+
+    ApproachEnemiesVector(enemies, 0, blocks, right, bottom);
+    ApproachEnemiesScalar(enemies, blocks, count, right, bottom);
+#else
+    ApproachEnemiesScalar(enemies, 0, count, right, bottom);
+#endif
+}
+
+// Move every free enemy towards the target, or away from the enemy it overlaps
+static void ChaseEnemies(EnemyStore *enemies, Vector2 target)
+{
+    int count = enemies->count;
+
+#if defined(ENEMY_KERNELS_VECTOR)
+    int blocks = count & ~3;
+
+    ChaseEnemiesVector(enemies, 0, blocks, target);
+    ChaseEnemiesScalar(enemies, blocks, count, target);
+#else
+    ChaseEnemiesScalar(enemies, 0, count, target);
+#endif
+}
@@ -0,0 +1,273 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include <stdbool.h>
+#include "raylib.h" // Only for Rectangle and Vector2, the core never calls into raylib
+
+//----------------------------------------------------------------------------------
+// Some Defines
+//----------------------------------------------------------------------------------
+#define GAME_WIDTH 1600 // Virtual resolution the game is simulated and drawn at
+#define GAME_HEIGHT 900
+#define NUM_SHOOTS 50 // Initial shuriken pool capacity, grows on demand
+#define NUM_MAX_ENEMIES 60 // Initial enemy pool capacity, grows on demand
+#define MAX_WAVES 32
+#define MAX_WAVE_KINDS 128
+#define MAX_WAVE_SPAWNS 4096 // Spawn order entries of all waves together, see WaveDesc
+#define WAVE_TITLE_SIZE 32
+#define GRID_CELL_SIZE 64
+#define GRID_BUCKETS 4096 // Must be a power of two
+#define GRID_QUERY_MARGIN 36 // Largest enemy size plus the distance it can move after the grid is built
+#define SIM_TICK_RATE 60 // Simulation ticks per second, all per-tick speeds and timers assume it
+
+// Enemy flags
+#define ENEMY_ACTIVE 1
+#define ENEMY_FREE 2 // for walking freely
+#define ENEMY_COLLIDED 4
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum
+{
+    SIDE_RIGHT = 0,
+    SIDE_LEFT,
+    SIDE_BOTTOM,
+    SIDE_TOP
+} SpawnSide;
+
+// Sprite ids, the frontend maps them to textures
+typedef enum
+{
+    PLAYER_WALK = 0,
+    PLAYER_DAMAGE,
+    PLAYER_DEAD,
+    PLAYER_SPRITE_COUNT
+} PlayerSprite;
+
+typedef enum
+{
+    SPRITE_FLAM = 0,
+    SPRITE_FLAM2,
+    SPRITE_CYCLOPE,
+    SPRITE_REPTILE,
+    SPRITE_SNAKE,
+    ENEMY_SPRITE_COUNT
+} EnemySprite;
+
+// Things the frontend may want to hear about (sounds, music)
+typedef enum
+{
+    GAME_EVENT_PLAYER_HIT = 0,
+    GAME_EVENT_ENEMY_HIT,
+    GAME_EVENT_PLAYER_DEAD
+} GameEvent;
+
+// Subsystems of GameStep(), bracketed by GameHooks.onStage for profiling
+typedef enum
+{
+    GAME_STAGE_WAVE = 0,
+    GAME_STAGE_PLAYER,
+    GAME_STAGE_APPROACH,   // Enemies walking in from their spawn side
+    GAME_STAGE_SEPARATION, // Grid build and enemy overlap tests
+    GAME_STAGE_CHASE,      // Enemies following the player
+    GAME_STAGE_ANIMATION,
+    GAME_STAGE_SHOOTS,     // Shuriken spawn, movement and culling
+    GAME_STAGE_COLLISION,  // Hit tests, runs nested inside PLAYER and SHOOTS
+    GAME_STAGE_RELEASE,    // Pool compaction
+    GAME_STAGE_COUNT
+} GameStage;
+
+// What an enemy spawns as
+typedef struct EnemyKind
+{
+    EnemySprite sprite;
+    int life;
+    int type;
+    float size; // Width and height
+    float speed; // Per tick, on both axes
+    int sides; // Bit (1 << SpawnSide) for every side it may come from
+} EnemyKind;
+
+// Spawn curve of a wave: t ticks into it, count * (t / duration)^exponent of its enemies
+// are due, and at most budget of them enter the pool per tick. The enemies spawn as the
+// kinds listed in spawns[firstSpawn, firstSpawn + patternLength), in that order, over and
+// over. The pattern is the wave's mix reduced by the counts' common factor, so a wave of
+// 5000 flam and 5000 snake stores two entries, not 10000.
+typedef struct WaveDesc
+{
+    int firstSpawn;
+    int patternLength;
+    int count;
+    int duration;
+    float exponent; // Below 1 front-loads the wave, above 1 holds it back
+    int budget;
+    int next; // Wave that follows once every enemy is killed
+    bool victory; // Clearing it wins the game, the run goes on
+    char title[WAVE_TITLE_SIZE]; // Shown while the wave fades in, may be empty
+} WaveDesc;
+
+// Waves compiled by CompileWaves() (waves.h) into flat tables, read-only while playing
+typedef struct WaveTable
+{
+    int waveCount;
+    int kindCount;
+    int spawnCount;
+    WaveDesc waves[MAX_WAVES];
+    EnemyKind kinds[MAX_WAVE_KINDS];
+    unsigned char spawns[MAX_WAVE_SPAWNS]; // Index into kinds, the spawn pattern of every wave one after the other
+} WaveTable;
+
+typedef struct Player
+{
+    Rectangle playerSrc;
+    Rectangle playerDest;
+    Vector2 origin;
+    Vector2 speed;
+    Vector2 prev; // Position at the start of the tick, for interpolation
+    PlayerSprite sprite;
+} Player;
+
+// Cold per-enemy data, only touched by the animation and draw code
+typedef struct Enemy
+{
+    int enemyFrame;
+    int type;
+    Rectangle enemySrc;
+    Vector2 origin;
+    EnemySprite enemySprite;
+} Enemy;
+
+// Hot per-enemy data, stored as structure-of-arrays so the movement kernels
+// stream through contiguous lanes instead of whole Enemy structs.
+// Live enemies are packed in [0, count); dead ones are swap-removed at the end of the tick.
+typedef struct EnemyStore
+{
+    int count;
+    int capacity; // Kept a multiple of four, grows by doubling
+    float *x;
+    float *y;
+    float *prevX; // Position at the start of the tick, for interpolation
+    float *prevY;
+    float *vx;
+    float *vy;
+    float *width;
+    float *height;
+    float *sepX; // Position of the overlapping enemy to step away from
+    float *sepY;
+    int *life;
+    int *flags;
+    int *side;
+    int *dir;
+} EnemyStore;
+
+typedef struct Shoot
+{
+    bool active;
+    int bulletDirection;
+    int bulletFrame;
+    Rectangle shootSrc;
+    Rectangle rec;
+    Vector2 origin;
+    Vector2 speed;
+    Vector2 prev; // Position at the start of the tick, for interpolation
+} Shoot;
+
+// Optional callbacks, any of them may be NULL
+typedef struct GameHooks
+{
+    void (*onEvent)(GameEvent event, void *userData);
+    void (*onStage)(GameStage stage, bool begin, void *userData); // A stage may run in several pieces per step
+    void *userData;
+} GameHooks;
+
+// Everything the simulation reads from the outside world in one tick
+typedef struct GameInput
+{
+    bool up;
+    bool down;
+    bool left;
+    bool right;
+    bool fire;         // Held down
+    bool pausePressed; // Pressed this tick
+    int screenWidth;
+    int screenHeight;
+} GameInput;
+
+typedef struct GameState
+{
+    GameHooks hooks;
+    unsigned int rngState;
+    int screenWidth;
+    int screenHeight;
+
+    bool gameOver;
+    bool pause;
+    bool victory;
+    int score;
+    int frameCount; // Time counter (60|1sec)
+
+    // Waves
+    const WaveTable *waveTable; // Kept across restarts, NULL runs the built-in waves
+    int wave; // Index into waveTable->waves
+    int activeEnemies; // Size of the current wave
+    int enemiesKill;
+    int spawned; // Enemies of the current wave already in the pool
+    int spawnTicks; // Since the current wave started spawning
+    bool smooth;
+    bool load; // Start spawning the current wave on the next step
+    float alpha; // Wave title fade
+
+    // Player
+    Player player;
+    bool moving;
+    bool canWalkR; // for collision (not fixed yet)
+    bool canWalkL;
+    bool canWalkD;
+    bool canWalkU;
+    bool alive;
+    int direction;
+    int dirImg;
+    int playerFrame;
+    int lifeCount;
+    int invencibleCount;
+    int damageAnimCount;
+    bool colision;
+    bool damageAnim;
+    int timerCount;
+    int shootRate;
+
+    // Entity pools
+    EnemyStore enemies;
+    Enemy *enemy; // Cold data, indexed like the enemy store
+    int deadEnemies; // Killed this tick, still waiting to be released
+    Shoot *shoot; // Live shurikens are packed in [0, shootCount)
+    int shootCount;
+    int shootCapacity;
+
+    // Enemy spatial hash, rebuilt every tick
+    int gridHead[GRID_BUCKETS];
+    int *gridNext; // Grows with the enemy store
+    int *gridQuery;
+    unsigned int gridVisited[GRID_BUCKETS]; // Query stamp of the last query that walked each bucket
+    unsigned int gridStamp;
+} GameState;
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration
+//------------------------------------------------------------------------------------
+// The state must be zeroed before the first GameInit(); later calls restart the game
+// and reuse the pools. Hooks are kept across restarts.
+void GameInit(GameState *state, unsigned int seed, int screenWidth, int screenHeight);
+void GameStep(GameState *state, const GameInput *input); // Advance one 1/SIM_TICK_RATE tick
+void GameFree(GameState *state);
+
+// Append an active shuriken at the player's position, for tools that need to
+// saturate the pool. Returns NULL only if the pool can't grow.
+Shoot *GameSpawnShoot(GameState *state, int direction);
+
+// Spawn what is left of the current wave at once, for tools that need the whole
+// population from the first tick
+void GameFlushSpawns(GameState *state);
+
+#endif // GAME_H
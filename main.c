@@ -1,20 +1,32 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "raylib.h"
+#include "game.h"
+#include "waves.h"
+#include "profiler.h"
+#include "sprites.h"
+#include "assets.h"
+#include "pack.h"
+#include "render.h"
+#include "music.h"
+#include "sfx.h"
+#include "scores.h"
 
 #if defined(PLATFORM_WEB)
 #include <emscripten/emscripten.h>
+#else
+#define ASSET_LOADER_THREADED // No threads on the web, assets are decoded between frames instead
+#include <pthread.h>
 #endif
 
 //----------------------------------------------------------------------------------
 // Some Defines
 //----------------------------------------------------------------------------------
-#define NUM_SHOOTS 50
-#define NUM_MAX_ENEMIES 60
-#define FIRST_WAVE 20
-#define SECOND_WAVE 30
-#define THIRD_WAVE 50
-#define BOSS_WAVE 50
-#define SURVIVE_WAVE 60
+#define NUM_CACHED_TEXTURES 64 // Initial texture cache capacity, grows on demand
+#define SIM_MAX_FRAME_TIME 0.25f // Longer frames (window drags, breakpoints) are clamped
+#define MAX_LATCHED_KEYS 512
+#define MAX_ASSET_UPLOADS 4 // GPU uploads per rendered frame, so the loading screen keeps drawing
 
 //----------------------------------------------------------------------------------
 // Types and Structures Definition
@@ -25,29 +37,13 @@ typedef enum GameScreen
     TITLE,
     GAMEPLAY,
     NARRATIVE,
-    ENDING
+    ENDING,
+    LOADING // Waiting on the asset loader before switching to pendingScreen
 } GameScreen;
-typedef enum
-{
-    FIRST = 0,
-    SECOND,
-    THIRD,
-    BOSS,
-    SURVIVE
-} EnemyWave;
-
-typedef struct Player
-{
-    Rectangle playerSrc;
-    Rectangle playerDest;
-    Vector2 origin;
-    Vector2 speed;
-    Texture2D playerSprite;
-} Player;
 
 typedef struct Playerscore
 {
-    char name[11];
+    char name[RANK_NAME_SIZE];
     int fscore;
 } Playerscore;
 
@@ -56,37 +52,8 @@ typedef struct Life
     Rectangle lifeSrc;
     Rectangle lifeDest;
     Vector2 origin;
-    Texture2D life;
 } Life;
 
-typedef struct Enemy
-{
-    bool active;
-    bool free; // for walking freely
-    bool collided;
-    int enemyFrame;
-    int enemyDir;
-    int life;
-    int type;
-    Rectangle enemySrc;
-    Rectangle enemyDest;
-    Vector2 speed;
-    Vector2 origin;
-    Texture2D enemySprite;
-} Enemy;
-
-typedef struct Shoot
-{
-    bool active;
-    int bulletDirection;
-    int bulletFrame;
-    Rectangle shootSrc;
-    Rectangle rec;
-    Vector2 origin;
-    Vector2 speed;
-    Texture2D shootSprite;
-} Shoot;
-
 typedef struct Song
 {
     bool musicPaused;
@@ -99,71 +66,113 @@ typedef struct SoundEffect
     Sound sound;
 } SoundEffect;
 
+typedef struct CachedTexture
+{
+    char fileName[256];
+    int refCount;
+    Texture2D texture;
+} CachedTexture;
+
+typedef struct AssetRequest
+{
+    AssetType type;
+    AssetGroup group;
+    const char *fileName;
+    void *target; // Texture2D, Sound, SFX id or Music filled in by the upload
+    float volume;
+    int voices; // ASSET_SFX only, how many instances can play at once
+} AssetRequest;
+
+// What the worker hands over to the main thread for one request
+typedef struct DecodedAsset
+{
+    Image image;
+    Wave wave;
+    unsigned char *data; // Compressed music file, must outlive the stream
+    unsigned int dataSize;
+    bool packed; // Points into the asset pack, nothing to free
+} DecodedAsset;
+
 //------------------------------------------------------------------------------------
 // Global Variables Declaration
 //------------------------------------------------------------------------------------
-int screenWidth = 1600;
-int screenHeight = 900;
+// Virtual resolution, everything is laid out in it whatever the window size
+int screenWidth = GAME_WIDTH;
+int screenHeight = GAME_HEIGHT;
 
-static bool gameOver = false;
-static bool pause = false;
-static bool victory = false;
-static int score = 0;
+static GameState game = {0}; // Waves, player, enemies, shurikens and score
+static WaveTable waveTable = {0}; // Compiled from WAVES_FILE
 
-static Player player = {0};
-static Player shadow = {0};
 static Life playerLife[3] = {0};
-static Enemy enemy[NUM_MAX_ENEMIES] = {0};
-static Shoot shoot[NUM_SHOOTS] = {0};
-static EnemyWave wave = {0};
-static Playerscore rankplayer[10] = {0};
-
-static int shootRate = 0;
-static float alpha = 0.0f;
-
-static int activeEnemies = 0;
-static int enemiesKill = 0;
-static bool smooth = false;
-static bool load = true;
-
-// Player's moving animation
-bool moving;
-bool canWalkR = true; // for collision (not fixed yet)
-bool canWalkL = true;
-bool canWalkD = true;
-bool canWalkU = true;
-bool alive = true;
-int direction, dirImg, playerFrame, frameCount;
-
-// Player's life count
-int lifeCount = 3;
-int invencibleCount;
-int damageAnimCount;
-bool colision = true;
-bool damageAnim = false;
-
-// Timer variables
-int timerCount = 0;
+static ScoreBoard scoreBoard = {0}; // Latest copy published by the score client
+static char rankScoreText[SCORE_TOP_ROWS][16] = {0};
+static char rankPlayerText[48] = {0}; // Position of the last submitted score, or why it isn't there
+
+static CachedTexture *textureCache = NULL;
+static int textureCacheCapacity = 0;
+static bool compressedTexturesSupported = false; // DXT uploads work, probed once the window is up
+
+// Fixed timestep
+static double tickAccumulator = 0.0;
+static float interpolation = 0.0f; // How far the rendered frame is between the last two ticks [0..1]
+
+// Frame governor inputs, see UpdateFrameTarget()
+static float frameBudget = 1.0f / 60; // Seconds per frame at the target frame rate
+static double frameStart = 0.0;
+static float frameBusy = 0.0f; // Update and draw time of the last frame, without waiting for the swap
+
+// What the cached HUD layer currently shows, it is redrawn when the game disagrees
+static int hudScore = -1;
+static int hudLifeCount = -1;
+
+// Input edges are latched every rendered frame and consumed by the next tick,
+// so presses are neither lost nor repeated when ticks and frames don't line up
+static bool keyLatched[MAX_LATCHED_KEYS] = {0};
+static bool mousePressedLatched[3] = {0};
+static bool mouseReleasedLatched[3] = {0};
+static int charLatched[16] = {0};
+static int charLatchedCount = 0;
+static int charLatchedRead = 0;
+
+// Gameplay sprites (player, shadow, hearts, enemies, shurikens) all come from one
+// atlas page once `make atlas` has been run, so a whole horde is drawn in one batch
+#define SPRITE_NAME(id, fileName) #id,
+
+static const char *spriteNames[ATLAS_SPRITE_COUNT] = { SPRITE_LIST(SPRITE_NAME) };
+static const AtlasSprite playerAtlas[PLAYER_SPRITE_COUNT] = { ATLAS_PLAYER_WALK, ATLAS_PLAYER_DAMAGE, ATLAS_PLAYER_DEAD };
+static const AtlasSprite enemyAtlas[ENEMY_SPRITE_COUNT] = { ATLAS_FLAM, ATLAS_FLAM2, ATLAS_CYCLOPE, ATLAS_REPTILE, ATLAS_SNAKE };
+
+static bool atlasAvailable = false;
+static Texture2D atlasTexture = {0};
+static Rectangle spriteRects[ATLAS_SPRITE_COUNT] = {0}; // Where each sprite sits in the atlas
+static Texture2D spriteTextures[ATLAS_SPRITE_COUNT] = {0}; // Loose files, only loaded without the atlas
+
+// Player's shadow, follows the player 14 pixels below
+Rectangle shadowSrc;
+Rectangle shadowDest;
+Vector2 shadowOrigin;
 
 // Music variables
 Song backgroundMusic = {0};
 Song backgroundMenu = {0};
-SoundEffect gameOverSound = {0};
-SoundEffect damageTaken = {0};
-SoundEffect damageDone = {0};
+int gameOverSound = -1; // SFX ids, played through the voice pool
+int damageTaken = -1;
+int damageDone = -1;
 
 // Button variables
 bool btnAction = false;
 bool isPressed = false;
 Sound fxButton;
-Texture2D button;
+Texture2D button; // Points to buttonIdle or buttonDown, owned by the texture cache
+Texture2D buttonIdle, buttonDown;
 Rectangle sourceRec;
 Rectangle btnBounds;
 Vector2 mousePoint = {0, 0};
 
 bool btnActionCredits = false;
 bool isPressedCredits = false;
-Texture2D buttonCredits;
+Texture2D buttonCredits; // Points to creditsIdle or creditsDown, owned by the texture cache
+Texture2D creditsIdle, creditsDown;
 Rectangle creditsRec;
 Rectangle creditsBounds;
 
@@ -197,17 +206,44 @@ Texture2D rules;
 char name[11] = "\0"; // NOTE: One extra space required for null terminator char '\0'
 int letterCount = 0;
 
-Rectangle textBox = {675, 180, 250, 50};
+Rectangle textBox = {350, 180, 900, 50}; // Room for RANK_NAME_SIZE - 1 wide characters at size 40
 bool mouseOnText = false;
 
+char letterCountText[32] = {0}; // Formatted when letterCount changes
+int letterCountShown = -1;
+
 int framesCounter = 0;
 bool endcount = false;
 Playerscore player1;
 
+// Asset loader, the worker decodes files in this order and the main thread uploads them.
+// The logo screen's own assets are loaded up front in main().
+#define ASSET_REQUEST(type, group, fileName, target, volume, voices) {type, group, fileName, target, volume, voices},
+#define SPRITE_REQUEST(id, fileName) {ASSET_SPRITE, ASSET_GROUP_GAMEPLAY, fileName, &spriteTextures[id], 0, 0},
+
+static const AssetRequest assetRequests[] = {
+    ASSET_LIST(ASSET_REQUEST)
+    SPRITE_LIST(SPRITE_REQUEST)
+};
+
+#define ASSET_COUNT (int)(sizeof(assetRequests) / sizeof(assetRequests[0]))
+
+static DecodedAsset decodedAssets[ASSET_COUNT] = {0};
+static int assetsDecoded = 0; // Published by the worker with release stores
+static int assetsUploaded = 0;
+#if defined(ASSET_LOADER_THREADED)
+static pthread_t assetThread;
+static bool assetThreadRunning = false;
+static bool assetLoaderQuit = false;
+#endif
+
+GameScreen pendingScreen = TITLE;
+
 //------------------------------------------------------------------------------------
 // Module Functions Declaration (local)
 //------------------------------------------------------------------------------------
 void InitGame(void);
+static void LoadWaves(void);
 void UpdateGame(void);
 void DrawGame(void);
 void UpdateLogo(void);
@@ -218,123 +254,316 @@ void UpdateNarrative(void);
 void DrawNarrative(void);
 void UnloadGame(void);
 void UpdateDrawFrame(void);
+void UpdateScreen(void);
 void DrawScreen(void);
+void LatchInput(void);
+void ClearLatchedInput(void);
+bool LatchedKeyPressed(int key);
+bool LatchedMouseButtonPressed(int button);
+bool LatchedMouseButtonReleased(int button);
+int LatchedCharPressed(void);
+static inline Rectangle InterpolateRec(Rectangle rec, float prevX, float prevY);
+static inline bool SpriteVisible(Rectangle dest, Vector2 origin, Rectangle view);
+static void DrawCachedLayers(void);
+static bool PackedImage(const char *fileName, Image *image);
+static bool PackedWave(const char *fileName, Wave *wave);
+static const unsigned char *PackedFileData(const char *fileName, unsigned int *size);
+static bool ProbeCompressedTextures(void);
+static void FreeDecodedAsset(DecodedAsset *decoded);
 void scorerank(void);
+static void UpdateScoreBoard(void);
 void Input_text(void);
 void UpdateEnd(void);
 void DrawEnd(void);
+Texture2D AcquireTexture(const char *fileName);
+void ReleaseTexture(Texture2D texture);
+void AssignTexture(Texture2D *slot, const char *fileName);
+void UnloadTextureCache(void);
+int CountCachedTextures(void);
+Texture2D AdoptTexture(const char *fileName, Texture2D texture);
+bool LoadAtlasRects(void);
+static void DrawSprite(AtlasSprite sprite, Rectangle src, Rectangle dest, Vector2 origin, SpriteLayer layer);
+void StartAssetLoader(void);
+void UpdateAssetLoader(void);
+void StopAssetLoader(void);
+bool AssetGroupReady(AssetGroup group);
+float AssetLoaderProgress(void);
+void ChangeScreen(GameScreen screen);
+void UpdateLoading(void);
+void DrawLoading(void);
+void OnGameEvent(GameEvent event, void *userData);
 
 //------------------------------------------------------------------------------------
 // Program main entry point
 //------------------------------------------------------------------------------------
 int main(void)
 {
-    // Config for resizable screen
-    // More screen size not implemented, for now just 1600:900
-    // SetConfigFlags(FLAG_WINDOW_RESIZABLE | FLAG_VSYNC_HINT);
-    Image windowIcon = LoadImage("Assets/NinjaAdventure/icon.png");
+    // Any window size works, the game is drawn at 1600:900 and letterboxed
+    SetConfigFlags(FLAG_WINDOW_RESIZABLE);
+
+    // Decoded assets come straight out of the pack when `make pack` has been run
+    bool packOpen = OpenAssetPack(ASSET_PACK_FILE);
+
+    Image windowIcon = {0};
+    bool iconPacked = PackedImage(ICON_FILE, &windowIcon);
+
+    if (!iconPacked)
+        windowIcon = LoadImage(ICON_FILE);
 
     InitWindow(screenWidth, screenHeight, "NINJA DEFENDERS");
     SetWindowIcon(windowIcon);
+    compressedTexturesSupported = ProbeCompressedTextures();
+    TraceLog(LOG_INFO, packOpen ? "PACK: Loading assets from %s" : "PACK: No usable %s, loading loose files", ASSET_PACK_FILE);
+
+    if (!iconPacked)
+        UnloadImage(windowIcon);
+
+    SetWindowMinSize(screenWidth / 4, screenHeight / 4);
+    InitFrameTarget(screenWidth, screenHeight);
     InitAudioDevice();
-    InitGame();
+    StartMusicPlayer();
+
+    // The logo and loading screens are up on the first frame, everything else streams in
+    AssignTexture(&backgroundLogo, LOGO_BACKGROUND_FILE);
+    AssignTexture(&loading, LOADING_BACKGROUND_FILE);
+
+    unsigned int menuMusicSize = 0;
+    const unsigned char *menuMusic = PackedFileData(MENU_MUSIC_FILE, &menuMusicSize);
+
+    if (menuMusic != NULL)
+        backgroundMenu.song = LoadMusicStreamFromMemory(GetFileExtension(MENU_MUSIC_FILE), menuMusic, menuMusicSize);
+    else
+        backgroundMenu.song = LoadMusicStream(MENU_MUSIC_FILE);
+    SetSongVolume(&backgroundMenu.song, 0.2f);
+
+    // The leaderboard is written off the main thread, to rankscore.db or to the score
+    // daemon given as SCORE_SERVER=address:port
+    StartScoreClient(getenv("SCORE_SERVER"));
 
-    int framesCounter = 0;
+    StartAssetLoader();
+    LoadWaves();
+    InitGame();
 
 #if defined(PLATFORM_WEB)
-    emscripten_set_main_loop(UpdateDrawFrame, 144, 1);
+    // Let the browser drive the frame rate, the simulation keeps its own fixed tick
+    emscripten_set_main_loop(UpdateDrawFrame, 0, 1);
 #else
-
-    SetTargetFPS(60);
+    // Render at the monitor refresh rate, the simulation keeps its own fixed tick
+    int refreshRate = GetMonitorRefreshRate(GetCurrentMonitor());
+    SetTargetFPS((refreshRate > 0) ? refreshRate : 60);
+    frameBudget = 1.0f / ((refreshRate > 0) ? refreshRate : 60);
 
     // Main game loop
     while (!WindowShouldClose()) // Detect window close button or ESC key
     {
-        switch (currentScreen)
-        {
-        case LOGO:
-        {
-            UpdateLogo();
+        UpdateDrawFrame();
+    }
+#endif
 
-            framesCounter++;
+    // De-Initialization
+    //--------------------------------------------------------------------------------
+    UnloadGame();       // Unload loaded data (textures, sounds, models...)
+    CloseAudioDevice(); // Close audio device
+    CloseWindow();      // Close window and OpenGL context
+    //--------------------------------------------------------------------------------
 
-            // Wait for 3 seconds (180 frames) before jumping to TITLE screen
-            if (framesCounter == 180)
-            {
-                currentScreen = TITLE;
-            }
-        }
-        break;
+    return 0;
+}
 
-        case TITLE:
-        {
-            UpdateTitle();
+//------------------------------------------------------------------------------------
+// Update and draw one rendered frame
+//------------------------------------------------------------------------------------
+// The simulation advances in fixed ticks of 1/SIM_TICK_RATE seconds, as many as the
+// elapsed time asks for, so it runs at the same speed on any display. Slow frames run
+// several ticks before drawing once, and the draw interpolates between the last two ticks.
+void UpdateDrawFrame(void)
+{
+    const double tick = 1.0 / SIM_TICK_RATE;
+    float frameTime = GetFrameTime();
 
-            // If button play is pressed, change to GAMEPLAY screen
-            if (isPressed)
-            {
-                currentScreen = NARRATIVE;
-                isPressed = false;
-            }
-        }
-        break;
+    frameStart = GetTime();
+    UpdateFrameTarget(frameTime, frameBusy, frameBudget);
 
-        case NARRATIVE:
-        {
-            UpdateNarrative();
+    if (frameTime > SIM_MAX_FRAME_TIME)
+        frameTime = SIM_MAX_FRAME_TIME;
 
-            // If button play is pressed, change to GAMEPLAY screen
-            if (narrativeScreen == 3)
-            {
-                currentScreen = GAMEPLAY;
-                narrativeScreen = 0; // To replay the narrative
-            }
+    tickAccumulator += frameTime;
+    LatchInput();
+    UpdateAssetLoader();
+    UpdateMusicPlayer();
+    UpdateScoreBoard();
+
+    PROFILE_BEGIN(PROFILE_ZONE_UPDATE);
+
+    while (tickAccumulator >= tick)
+    {
+        UpdateScreen();
+        ClearLatchedInput();
+        tickAccumulator -= tick;
+    }
+
+    PROFILE_END(PROFILE_ZONE_UPDATE);
+
+    // Hits from every tick of this frame start their sounds together
+    UpdateSfx();
+
+    interpolation = (float)(tickAccumulator / tick);
+
+    // Draw the current screen
+    DrawScreen();
+
+    PROFILE_FRAME();
+}
+
+//------------------------------------------------------------------------------------
+// Update the current screen (one tick)
+//------------------------------------------------------------------------------------
+void UpdateScreen(void)
+{
+    static int framesCounter = 0;
+
+    switch (currentScreen)
+    {
+    case LOGO:
+    {
+        UpdateLogo();
+
+        framesCounter++;
+
+        // Wait for 3 seconds (180 frames) before jumping to TITLE screen
+        if (framesCounter == 180)
+        {
+            ChangeScreen(TITLE);
         }
-        break;
+    }
+    break;
+
+    case TITLE:
+    {
+        UpdateTitle();
 
-        case GAMEPLAY:
+        // If button play is pressed, change to GAMEPLAY screen
+        if (isPressed)
         {
-            UpdateGame();
+            ChangeScreen(NARRATIVE);
+            isPressed = false;
+        }
+    }
+    break;
 
-            // Press R to change to ENDING screen
-            if (gameOver)
-            {
-                currentScreen = ENDING;
-            }
+    case NARRATIVE:
+    {
+        UpdateNarrative();
+
+        // If button play is pressed, change to GAMEPLAY screen
+        if (narrativeScreen == 3)
+        {
+            ChangeScreen(GAMEPLAY);
+            narrativeScreen = 0; // To replay the narrative
         }
-        break;
+    }
+    break;
 
-        case ENDING:
+    case GAMEPLAY:
+    {
+        UpdateGame();
+
+        // Press R to change to ENDING screen
+        if (game.gameOver)
         {
-            UpdateEnd();
+            currentScreen = ENDING;
+        }
+    }
+    break;
 
-            // Press enter to return to TITLE screen
-            if (IsKeyPressed(KEY_SPACE))
-            {
-                currentScreen = TITLE;
-                gameOver = false;
-                endcount = false;
-            }
+    case ENDING:
+    {
+        UpdateEnd();
+
+        // Press enter to return to TITLE screen
+        if (LatchedKeyPressed(KEY_SPACE))
+        {
+            ChangeScreen(TITLE);
+            game.gameOver = false;
+            endcount = false;
         }
+    }
+    break;
+
+    case LOADING:
+    {
+        UpdateLoading();
+    }
+    break;
+
+    default:
         break;
+    }
+}
 
-        default:
-            break;
-        }
+//------------------------------------------------------------------------------------
+// Latched input
+//------------------------------------------------------------------------------------
+void LatchInput(void)
+{
+    int key = GetKeyPressed();
+
+    while (key > 0)
+    {
+        if (key < MAX_LATCHED_KEYS)
+            keyLatched[key] = true;
 
-        // Draw the current screen
-        DrawScreen();
+        key = GetKeyPressed();
     }
-#endif
 
-    // De-Initialization
-    //--------------------------------------------------------------------------------
-    UnloadGame();       // Unload loaded data (textures, sounds, models...)
-    CloseAudioDevice(); // Close audio device
-    CloseWindow();      // Close window and OpenGL context
-    //--------------------------------------------------------------------------------
+    for (int button = 0; button < 3; button++)
+    {
+        if (IsMouseButtonPressed(button))
+            mousePressedLatched[button] = true;
 
-    return 0;
+        if (IsMouseButtonReleased(button))
+            mouseReleasedLatched[button] = true;
+    }
+
+    int ch = GetCharPressed();
+
+    while (ch > 0)
+    {
+        if (charLatchedCount < 16)
+            charLatched[charLatchedCount++] = ch;
+
+        ch = GetCharPressed();
+    }
+}
+
+void ClearLatchedInput(void)
+{
+    memset(keyLatched, 0, sizeof(keyLatched));
+    memset(mousePressedLatched, 0, sizeof(mousePressedLatched));
+    memset(mouseReleasedLatched, 0, sizeof(mouseReleasedLatched));
+    charLatchedCount = 0;
+    charLatchedRead = 0;
+}
+
+bool LatchedKeyPressed(int key)
+{
+    return (key >= 0) && (key < MAX_LATCHED_KEYS) && keyLatched[key];
+}
+
+bool LatchedMouseButtonPressed(int button)
+{
+    return mousePressedLatched[button];
+}
+
+bool LatchedMouseButtonReleased(int button)
+{
+    return mouseReleasedLatched[button];
+}
+
+// Same contract as GetCharPressed(): returns 0 once the queue is empty
+int LatchedCharPressed(void)
+{
+    return (charLatchedRead < charLatchedCount) ? charLatched[charLatchedRead++] : 0;
 }
 
 //------------------------------------------------------------------------------------
@@ -342,255 +571,89 @@ int main(void)
 //------------------------------------------------------------------------------------
 void InitGame(void)
 {
-    // Secure that the game will start properly
-    alive = true;
-    damageAnim = false;
-    lifeCount = 3;
-    timerCount = 0;
-
-    // Initialize game variables
-    shootRate = 0;
-    pause = false;
-    gameOver = false;
-    victory = false;
-    smooth = false;
-    wave = FIRST;
-    activeEnemies = FIRST_WAVE;
-    enemiesKill = 0;
-    score = 0;
-    alpha = 0;
+    // Waves, player, enemies and shurikens live in the simulation core
+    GameInit(&game, (unsigned int)GetRandomValue(1, 0x7fffffff), screenWidth, screenHeight);
+    game.hooks.onEvent = OnGameEvent;
+    PROFILE_HOOK(game.hooks);
 
     // Initialize background variables
-    backgroundMain = LoadTexture("Assets/NinjaAdventure/Backgrounds/backgroundMain.png");
-    backgroundLogo = LoadTexture("Assets/NinjaAdventure/Backgrounds/background.png");
-    backgroundTitle = LoadTexture("Assets/NinjaAdventure/Backgrounds/backgroud_titlescreen.png");
-    credits = LoadTexture("Assets/NinjaAdventure/Backgrounds/credits.png");
-    narrative = LoadTexture("Assets/NinjaAdventure/Backgrounds/narrative.png");
-    loading = LoadTexture("Assets/NinjaAdventure/Backgrounds/loading.png");
-    rules = LoadTexture("Assets/NinjaAdventure/Backgrounds/rules.png");
     bgSrc.x = 0;
     bgSrc.y = 0;
     bgSrc.width = 1280;
     bgSrc.height = 720;
     bgDest.x = 0;
     bgDest.y = 0;
-    bgDest.width = GetScreenWidth();
-    bgDest.height = GetScreenHeight();
+    bgDest.width = screenWidth;
+    bgDest.height = screenHeight;
     bgOrigin.x = 0;
     bgOrigin.y = 0;
 
-    // Initialize audio variables
-    backgroundMusic.song = LoadMusicStream("Assets/NinjaAdventure/Musics/4 - Village.ogg");
-    SetMusicVolume(backgroundMusic.song, 0.2);
-
-    backgroundMenu.song = LoadMusicStream("Assets/NinjaAdventure/Musics/1 - Adventure Begin.ogg");
-    SetMusicVolume(backgroundMenu.song, 0.2);
-
-    narrativeMusic.song = LoadMusicStream("Assets/NinjaAdventure/Musics/13 - Mystical.ogg");
-    SetMusicVolume(narrativeMusic.song, 0.4);
-
-    gameOverSound.sound = LoadSound("Assets/NinjaAdventure/Sounds/Game/GameOver.wav");
-    SetSoundVolume(gameOverSound.sound, 0.5);
-
-    damageTaken.sound = LoadSound("Assets/NinjaAdventure/Sounds/Game/Hit4.wav");
-    SetSoundVolume(damageTaken.sound, 0.2);
-
-    damageDone.sound = LoadSound("Assets/NinjaAdventure/Sounds/Game/Sword2.wav");
-    SetSoundVolume(damageDone.sound, 0.2);
-
-    continueNarrative.sound = LoadSound("Assets/NinjaAdventure/Sounds/Menu/Menu1.wav");
-    SetSoundVolume(continueNarrative.sound, 0.6);
-
-    fxButton = LoadSound("Assets/NinjaAdventure/Sounds/Menu/Menu9.wav"); // Load button sound
-    SetSoundVolume(fxButton, 0.4);
-
     // Initialize Button variables
-    button = LoadTexture("Assets/NinjaAdventure/HUD/play_c.png"); // Load button texture
+    button = buttonIdle;
     sourceRec.x = 0;
     sourceRec.y = 0;
     sourceRec.width = 160;
     sourceRec.height = 52;
-    btnBounds.x = GetScreenWidth() / 1.985 - button.width / 2;
-    btnBounds.y = GetScreenHeight() / 1.65 + button.height / 2;
+    btnBounds.x = screenWidth / 1.985 - button.width / 2;
+    btnBounds.y = screenHeight / 1.65 + button.height / 2;
     btnBounds.width = 160;
     btnBounds.height = 52;
 
-    buttonCredits = LoadTexture("Assets/NinjaAdventure/HUD/credits_a.png"); // Load button texture
+    buttonCredits = creditsIdle;
     creditsRec.x = 0;
     creditsRec.y = 0;
     creditsRec.width = 50;
     creditsRec.height = 50;
-    creditsBounds.x = GetScreenWidth() - 75;
-    creditsBounds.y = GetScreenHeight() - 75;
+    creditsBounds.x = screenWidth - 75;
+    creditsBounds.y = screenHeight - 75;
     creditsBounds.width = 40;
     creditsBounds.height = 40;
 
-    // Initialize player
-    player.playerSrc.x = 0;
-    player.playerSrc.y = 0;
-    player.playerSrc.width = 16;
-    player.playerSrc.height = 16;
-    player.playerDest.x = GetScreenWidth() / 2;
-    player.playerDest.y = GetScreenHeight() / 2;
-    player.playerDest.width = 32;
-    player.playerDest.height = 32;
-    player.origin.x = player.playerDest.width / 2;
-    player.origin.y = player.playerDest.height / 2;
-    player.speed.x = 4;
-    player.speed.y = 4;
-    player.playerSprite = LoadTexture("Assets/NinjaAdventure/Actor/Characters/GreenNinja/SeparateAnim/walk.png");
-
     // Initialize player's shadow
-    shadow.playerSrc.x = 0;
-    shadow.playerSrc.y = 0;
-    shadow.playerSrc.width = 12;
-    shadow.playerSrc.height = 7;
-    shadow.playerDest.x = player.playerDest.x;
-    shadow.playerDest.y = player.playerDest.y + 14;
-    shadow.playerDest.width = 24;
-    shadow.playerDest.height = 14;
-    shadow.origin.x = shadow.playerDest.width / 2;
-    shadow.origin.y = shadow.playerDest.height / 2;
-    shadow.speed.x = 0;
-    shadow.speed.y = 0;
-    shadow.playerSprite = LoadTexture("Assets/NinjaAdventure/Actor/Characters/Shadow.png");
+    shadowSrc.x = 0;
+    shadowSrc.y = 0;
+    shadowSrc.width = 12;
+    shadowSrc.height = 7;
+    shadowDest.x = game.player.playerDest.x;
+    shadowDest.y = game.player.playerDest.y + 14;
+    shadowDest.width = 24;
+    shadowDest.height = 14;
+    shadowOrigin.x = shadowDest.width / 2;
+    shadowOrigin.y = shadowDest.height / 2;
 
     // Initialize player's life
-    playerLife[0].life = LoadTexture("Assets/NinjaAdventure/HUD/Heart.png");
     playerLife[0].lifeSrc.x = 0;
     playerLife[0].lifeSrc.y = 0;
     playerLife[0].lifeSrc.width = 16.2;
     playerLife[0].lifeSrc.height = 16.2;
     playerLife[0].lifeDest.x = 40;
-    playerLife[0].lifeDest.y = GetScreenHeight() - 60;
+    playerLife[0].lifeDest.y = screenHeight - 60;
     playerLife[0].lifeDest.width = 32;
     playerLife[0].lifeDest.height = 32;
     playerLife[0].origin.x = 0;
     playerLife[0].origin.y = 0;
 
-    playerLife[1].life = LoadTexture("Assets/NinjaAdventure/HUD/Heart.png");
     playerLife[1].lifeSrc.x = 0;
     playerLife[1].lifeSrc.y = 0;
     playerLife[1].lifeSrc.width = 16.2;
     playerLife[1].lifeSrc.height = 16.2;
     playerLife[1].lifeDest.x = 85;
-    playerLife[1].lifeDest.y = GetScreenHeight() - 60;
+    playerLife[1].lifeDest.y = screenHeight - 60;
     playerLife[1].lifeDest.width = 32;
     playerLife[1].lifeDest.height = 32;
     playerLife[1].origin.x = 0;
     playerLife[1].origin.y = 0;
 
-    playerLife[2].life = LoadTexture("Assets/NinjaAdventure/HUD/Heart.png");
     playerLife[2].lifeSrc.x = 0;
     playerLife[2].lifeSrc.y = 0;
     playerLife[2].lifeSrc.width = 16.2;
     playerLife[2].lifeSrc.height = 16.2;
     playerLife[2].lifeDest.x = 130;
-    playerLife[2].lifeDest.y = GetScreenHeight() - 60;
+    playerLife[2].lifeDest.y = screenHeight - 60;
     playerLife[2].lifeDest.width = 32;
     playerLife[2].lifeDest.height = 32;
     playerLife[1].origin.x = 0;
     playerLife[1].origin.y = 0;
-
-    // Initialize right side enemies
-    for (int i = 0; i < NUM_MAX_ENEMIES; i += 4)
-    {
-        enemy[i].enemySrc.width = 16;
-        enemy[i].enemySrc.height = 16;
-        enemy[i].enemySrc.x = 0;
-        enemy[i].enemySrc.y = 0;
-        enemy[i].enemyDest.x = GetRandomValue(GetScreenWidth(), GetScreenWidth() + 1000);
-        enemy[i].enemyDest.y = GetRandomValue(0, GetScreenHeight() - enemy[i].enemyDest.height);
-        enemy[i].enemyDest.width = 16;
-        enemy[i].enemyDest.height = 16;
-        enemy[i].speed.x = 0.5;
-        enemy[i].speed.y = 0.5;
-        enemy[i].origin.x = enemy[i].enemyDest.width / 2;
-        enemy[i].origin.y = enemy[i].enemyDest.height / 2;
-        enemy[i].active = true;
-        enemy[i].free = false;
-        enemy[i].collided = false;
-    }
-
-    // Initialize left side enemies
-    for (int i = 1; i < NUM_MAX_ENEMIES; i += 4)
-    {
-        enemy[i].enemySrc.width = 16;
-        enemy[i].enemySrc.height = 16;
-        enemy[i].enemySrc.x = 0;
-        enemy[i].enemySrc.y = 0;
-        enemy[i].enemyDest.x = GetRandomValue(-1000, 0);
-        enemy[i].enemyDest.y = GetRandomValue(0, GetScreenHeight() - enemy[i].enemyDest.height);
-        enemy[i].enemyDest.width = 16;
-        enemy[i].enemyDest.height = 16;
-        enemy[i].speed.x = 0.5;
-        enemy[i].speed.y = 0.5;
-        enemy[i].origin.x = enemy[i].enemyDest.width / 2;
-        enemy[i].origin.y = enemy[i].enemyDest.height / 2;
-        enemy[i].active = true;
-        enemy[i].free = false;
-        enemy[i].collided = false;
-    }
-
-    // Initialize bottom side enemies
-    for (int i = 2; i < NUM_MAX_ENEMIES; i += 4)
-    {
-        enemy[i].enemySrc.width = 16;
-        enemy[i].enemySrc.height = 16;
-        enemy[i].enemySrc.x = 0;
-        enemy[i].enemySrc.y = 0;
-        enemy[i].enemyDest.x = GetRandomValue(0, GetScreenWidth() - enemy[i].enemyDest.width);
-        enemy[i].enemyDest.y = GetRandomValue(GetScreenHeight(), GetScreenHeight() + 1000);
-        enemy[i].enemyDest.width = 16;
-        enemy[i].enemyDest.height = 16;
-        enemy[i].speed.x = 0.5;
-        enemy[i].speed.y = 0.5;
-        enemy[i].origin.x = enemy[i].enemyDest.width / 2;
-        enemy[i].origin.y = enemy[i].enemyDest.height / 2;
-        enemy[i].active = true;
-        enemy[i].free = false;
-        enemy[i].collided = false;
-    }
-
-    // Initialize top side enemies
-    for (int i = 3; i < NUM_MAX_ENEMIES; i += 4)
-    {
-        enemy[i].enemySrc.width = 16;
-        enemy[i].enemySrc.height = 16;
-        enemy[i].enemySrc.x = 0;
-        enemy[i].enemySrc.y = 0;
-        enemy[i].enemyDest.x = GetRandomValue(0, GetScreenWidth() - enemy[i].enemyDest.width);
-        enemy[i].enemyDest.y = GetRandomValue(-1000, 0);
-        enemy[i].enemyDest.width = 16;
-        enemy[i].enemyDest.height = 16;
-        enemy[i].speed.x = 0.5;
-        enemy[i].speed.y = 0.5;
-        enemy[i].origin.x = enemy[i].enemyDest.width / 2;
-        enemy[i].origin.y = enemy[i].enemyDest.height / 2;
-        enemy[i].active = true;
-        enemy[i].free = false;
-        enemy[i].collided = false;
-    }
-
-    // Initialize shoots
-    for (int i = 0; i < NUM_SHOOTS; i++)
-    {
-        shoot[i].shootSrc.x = 0;
-        shoot[i].shootSrc.y = 0;
-        shoot[i].shootSrc.width = 16;
-        shoot[i].shootSrc.height = 16;
-        shoot[i].rec.x = player.playerDest.x;
-        shoot[i].rec.y = player.playerDest.y;
-        shoot[i].rec.width = 16;
-        shoot[i].rec.height = 16;
-        shoot[i].origin.x = shoot[i].rec.width / 2;
-        shoot[i].origin.y = shoot[i].rec.height / 2;
-        shoot[i].speed.x = 7;
-        shoot[i].speed.y = 7;
-        shoot[i].bulletFrame = 0;
-        shoot[i].active = false;
-        shoot[i].shootSprite = LoadTexture("Assets/NinjaAdventure/HUD/Shuriken_anim.png");
-    }
 }
 
 //------------------------------------------------------------------------------------
@@ -598,1152 +661,189 @@ void InitGame(void)
 //------------------------------------------------------------------------------------
 void UpdateGame(void)
 {
-    // Adjusting visual elements on resizabled window
-    if (IsWindowResized())
-    {
-        // Adjust background size
-        bgDest.width = GetScreenWidth();
-        bgDest.height = GetScreenHeight();
-
-        // player's life
-        playerLife[0].lifeDest.y = GetScreenHeight() - 60;
-        playerLife[1].lifeDest.y = GetScreenHeight() - 60;
-        playerLife[2].lifeDest.y = GetScreenHeight() - 60;
-    }
-
-    // Time counter (60|1sec)
-    frameCount++;
-
     // Rules screen
     mousePoint = GetMousePosition();
 
     if (CheckCollisionPointRec(mousePoint, (Rectangle){717, 680, 167, 43}))
     {
-        if (rulesOpen && IsMouseButtonPressed(MOUSE_BUTTON_LEFT))
+        if (rulesOpen && LatchedMouseButtonPressed(MOUSE_BUTTON_LEFT))
         {
             rulesOpen = false;
             PlaySound(fxButton);
         }
     }
 
-    if (!gameOver && !rulesOpen)
+    if (!game.gameOver && !rulesOpen)
     {
         // Background music
-        UpdateMusicStream(backgroundMusic.song);
-        PlayMusicStream(backgroundMusic.song);
+        PlaySong(&backgroundMusic.song);
 
-        if (IsKeyPressed('P'))
-            pause = !pause;
+        GameInput input = {0};
 
-        if (!pause)
-        {
-            switch (wave)
-            {
-            case FIRST:
-            {
-                if (load)
-                {
-                    // Initialize enemy sprite
-                    for (int i = 0; i < activeEnemies; i += 2)
-                    {
-                        enemy[i].enemySprite = LoadTexture("Assets/NinjaAdventure/Actor/Monsters/Flam2/SpriteSheet.png");
-                        enemy[i].life = 1;
-                        enemy[i].type = 1;
-                    }
-
-                    for (int i = 1; i < activeEnemies; i += 2)
-                    {
-                        enemy[i].enemySprite = LoadTexture("Assets/NinjaAdventure/Actor/Monsters/Flam/SpriteSheet.png");
-                        enemy[i].life = 1;
-                        enemy[i].type = 1;
-                    }
-
-                    load = false;
-                }
+        input.up = IsKeyDown(KEY_UP);
+        input.down = IsKeyDown(KEY_DOWN);
+        input.left = IsKeyDown(KEY_LEFT);
+        input.right = IsKeyDown(KEY_RIGHT);
+        input.fire = IsKeyDown(KEY_SPACE);
+        input.pausePressed = LatchedKeyPressed('P');
+        input.screenWidth = screenWidth;
+        input.screenHeight = screenHeight;
 
-                if (!smooth)
-                {
-                    alpha += 0.02f;
+        GameStep(&game, &input);
 
-                    if (alpha >= 1.0f)
-                        smooth = true;
-                }
+        // Empty hearts for the lives already lost
+        for (int i = 0; i < 3; i++)
+            playerLife[i].lifeSrc.x = (i < game.lifeCount) ? 0 : (playerLife[i].lifeSrc.width * 4) - 0.8;
 
-                if (smooth)
-                    alpha -= 0.02f;
+        // Shadow behaviour
+        shadowDest.x = game.player.playerDest.x;
+        shadowDest.y = game.player.playerDest.y + 14;
+    }
+    else
+    {
+        // Silent behind the rules and after dying
+        PlaySong(NULL);
 
-                if (enemiesKill == activeEnemies)
-                {
-                    enemiesKill = 0;
-
-                    for (int i = 0; i < activeEnemies; i++)
-                    {
-                        if (!enemy[i].active)
-                            enemy[i].active = true;
-                    }
-
-                    activeEnemies = SECOND_WAVE;
-                    wave = SECOND;
-                    smooth = false;
-                    load = true;
-                    alpha = 0.0f;
-                }
-            }
-            break;
+        if (LatchedKeyPressed(KEY_ENTER))
+        {
+            InitGame();
+            game.gameOver = false;
+        }
+    }
+}
 
-            case SECOND:
-            {
-                if (load)
-                {
-                    // Initialize enemy sprite
-                    for (int i = 0; i < activeEnemies; i += 3)
-                    {
-                        enemy[i].enemySprite = LoadTexture("Assets/NinjaAdventure/Actor/Monsters/Cyclope/SpriteSheet.png");
-                        enemy[i].life = 2;
-                        enemy[i].type = 2;
-                    }
-
-                    for (int i = 1; i < activeEnemies; i += 3)
-                    {
-                        enemy[i].enemySprite = LoadTexture("Assets/NinjaAdventure/Actor/Monsters/Flam/SpriteSheet.png");
-                        enemy[i].life = 1;
-                        enemy[i].type = 1;
-                    }
-
-                    for (int i = 2; i < activeEnemies; i += 3)
-                    {
-                        enemy[i].enemySprite = LoadTexture("Assets/NinjaAdventure/Actor/Monsters/Flam2/SpriteSheet.png");
-                        enemy[i].life = 1;
-                        enemy[i].type = 1;
-                    }
-
-                    load = false;
-                }
+// Sounds and music for what happened in the simulation
+void OnGameEvent(GameEvent event, void *userData)
+{
+    switch (event)
+    {
+    case GAME_EVENT_PLAYER_HIT:
+        PlaySfx(damageTaken);
+        break;
 
-                if (!smooth)
-                {
-                    alpha += 0.02f;
+    case GAME_EVENT_ENEMY_HIT:
+        PlaySfx(damageDone);
+        break;
 
-                    if (alpha >= 1.0f)
-                        smooth = true;
-                }
+    case GAME_EVENT_PLAYER_DEAD:
+        StopSong(&backgroundMusic.song);
+        PlaySfx(gameOverSound);
+        break;
 
-                if (smooth)
-                    alpha -= 0.02f;
+    default:
+        break;
+    }
+}
 
-                if (enemiesKill == activeEnemies)
-                {
-                    enemiesKill = 0;
-
-                    for (int i = 0; i < activeEnemies; i++)
-                    {
-                        if (!enemy[i].active)
-                            enemy[i].active = true;
-                    }
-
-                    activeEnemies = THIRD_WAVE;
-                    wave = THIRD;
-                    smooth = false;
-                    load = true;
-                    alpha = 0.0f;
-                }
-            }
-            break;
+//------------------------------------------------------------------------------------
+// Draw game (one frame)
+//------------------------------------------------------------------------------------
+void DrawGame(void)
+{
+    PROFILE_BEGIN(PROFILE_ZONE_DRAW);
 
-            case THIRD:
-            {
-                if (load)
-                {
-                    // Initialize enemy sprite
-                    for (int i = 0; i < activeEnemies; i += 5)
-                    {
-                        enemy[i].enemySprite = LoadTexture("Assets/NinjaAdventure/Actor/Monsters/Reptile.png");
-                        enemy[i].life = 3;
-                        enemy[i].type = 3;
-                        enemy[i].enemyDest.width = 32;
-                        enemy[i].enemyDest.height = 32;
-                    }
-
-                    for (int i = 1; i < activeEnemies; i += 5)
-                    {
-                        enemy[i].enemySprite = LoadTexture("Assets/NinjaAdventure/Actor/Monsters/Cyclope/SpriteSheet.png");
-                        enemy[i].life = 2;
-                        enemy[i].type = 2;
-                        enemy[i].enemyDest.width = 16;
-                        enemy[i].enemyDest.height = 16;
-                    }
-
-                    for (int i = 2; i < activeEnemies; i += 5)
-                    {
-                        enemy[i].enemySprite = LoadTexture("Assets/NinjaAdventure/Actor/Monsters/Flam/SpriteSheet.png");
-                        enemy[i].life = 1;
-                        enemy[i].type = 1;
-                        enemy[i].enemyDest.width = 16;
-                        enemy[i].enemyDest.height = 16;
-                    }
-
-                    for (int i = 3; i < activeEnemies; i += 5)
-                    {
-                        enemy[i].enemySprite = LoadTexture("Assets/NinjaAdventure/Actor/Monsters/Flam2/SpriteSheet.png");
-                        enemy[i].life = 1;
-                        enemy[i].type = 1;
-                        enemy[i].enemyDest.width = 16;
-                        enemy[i].enemyDest.height = 16;
-                    }
-
-                    for (int i = 4; i < activeEnemies; i += 5)
-                    {
-                        enemy[i].enemySprite = LoadTexture("Assets/NinjaAdventure/Actor/Monsters/Snake.png");
-                        enemy[i].life = 1;
-                        enemy[i].type = 1;
-                    }
-
-                    load = false;
-                }
+    ClearBackground(DARKGRAY);
 
-                if (!smooth)
-                {
-                    alpha += 0.02f;
+    if (!game.gameOver)
+    {
+        // Sprites are queued and drawn together by FlushSprites(), text goes on top of them
+        QueueCachedLayer(CACHED_BACKGROUND, LAYER_BACKGROUND);
+        QueueCachedLayer(CACHED_HUD, LAYER_HUD);
 
-                    if (alpha >= 1.0f)
-                        smooth = true;
-                }
+        // Rectangle for tracking character position (testes!)
+        // DrawRectangle(player.playerDest.x, player.playerDest.y, player.playerDest.width, player.playerDest.height, BLUE);
+        // The shadow follows the player 14 pixels below, so both use the player's interpolated position
+        const Player *player = &game.player;
+        Rectangle playerDest = InterpolateRec(player->playerDest, player->prev.x, player->prev.y);
+        Rectangle shadowRec = InterpolateRec(shadowDest, player->prev.x, player->prev.y + 14);
 
-                if (smooth)
-                    alpha -= 0.02f;
+        DrawSprite(ATLAS_SHADOW, shadowSrc, shadowRec, shadowOrigin, LAYER_SHADOW);
+        DrawSprite(playerAtlas[player->sprite], player->playerSrc, playerDest, player->origin, LAYER_ACTORS);
 
-                if (enemiesKill == activeEnemies)
-                {
-                    enemiesKill = 0;
-
-                    for (int i = 0; i < activeEnemies; i++)
-                    {
-                        if (!enemy[i].active)
-                            enemy[i].active = true;
-                    }
-
-                    activeEnemies = BOSS_WAVE;
-                    wave = BOSS;
-                    smooth = false;
-                    load = true;
-                    alpha = 0.0f;
-                }
-            }
-            break;
+        const EnemyStore *enemies = &game.enemies;
+        Rectangle view = {0, 0, screenWidth, screenHeight};
 
-            case BOSS:
+        for (int i = 0; i < enemies->count; i++)
+        {
+            if (enemies->flags[i] & ENEMY_ACTIVE)
             {
-                if (load)
-                {
-                    // Initialize enemy sprite
-                    // Initialize enemy sprite
-                    for (int i = 0; i < activeEnemies; i += 5)
-                    {
-                        enemy[i].enemySprite = LoadTexture("Assets/NinjaAdventure/Actor/Monsters/Reptile.png");
-                        enemy[i].life = 3;
-                        enemy[i].type = 3;
-                        enemy[i].enemyDest.width = 32;
-                        enemy[i].enemyDest.height = 32;
-                    }
-
-                    for (int i = 1; i < activeEnemies; i += 5)
-                    {
-                        enemy[i].enemySprite = LoadTexture("Assets/NinjaAdventure/Actor/Monsters/Cyclope/SpriteSheet.png");
-                        enemy[i].life = 2;
-                        enemy[i].type = 2;
-                        enemy[i].enemyDest.width = 16;
-                        enemy[i].enemyDest.height = 16;
-                    }
-
-                    for (int i = 2; i < activeEnemies; i += 5)
-                    {
-                        enemy[i].enemySprite = LoadTexture("Assets/NinjaAdventure/Actor/Monsters/Flam/SpriteSheet.png");
-                        enemy[i].life = 1;
-                        enemy[i].type = 1;
-                        enemy[i].enemyDest.width = 16;
-                        enemy[i].enemyDest.height = 16;
-                    }
-
-                    for (int i = 3; i < activeEnemies; i += 5)
-                    {
-                        enemy[i].enemySprite = LoadTexture("Assets/NinjaAdventure/Actor/Monsters/Flam2/SpriteSheet.png");
-                        enemy[i].life = 1;
-                        enemy[i].type = 1;
-                        enemy[i].enemyDest.width = 16;
-                        enemy[i].enemyDest.height = 16;
-                    }
-
-                    for (int i = 4; i < activeEnemies; i += 5)
-                    {
-                        enemy[i].enemySprite = LoadTexture("Assets/NinjaAdventure/Actor/Monsters/Snake.png");
-                        enemy[i].life = 1;
-                        enemy[i].type = 1;
-                    }
-
-                    load = false;
-                }
-
-                if (!smooth)
-                {
-                    alpha += 0.02f;
-
-                    if (alpha >= 1.0f)
-                        smooth = true;
-                }
+                const Enemy *enemy = &game.enemy[i];
+                Rectangle dest = InterpolateRec((Rectangle){enemies->x[i], enemies->y[i], enemies->width[i], enemies->height[i]}, enemies->prevX[i], enemies->prevY[i]);
 
-                if (smooth)
-                    alpha -= 0.02f;
+                // Waves spawn up to 1000px outside the screen, those never reach the queue
+                if (!SpriteVisible(dest, enemy->origin, view))
+                    continue;
 
-                if (enemiesKill == activeEnemies)
-                {
-                    enemiesKill = 0;
-
-                    for (int i = 0; i < activeEnemies; i++)
-                    {
-                        if (!enemy[i].active)
-                            enemy[i].active = true;
-                    }
-
-                    victory = true;
-                    activeEnemies = SURVIVE_WAVE;
-                    wave = SURVIVE;
-                    smooth = false;
-                    load = true;
-                    alpha = 0.0f;
-                }
+                DrawSprite(enemyAtlas[enemy->enemySprite], enemy->enemySrc, dest, enemy->origin, LAYER_ACTORS);
             }
-            break;
+        }
 
-            case SURVIVE:
-            {
-                if (load)
-                {
-                    // Initialize enemy sprite
-                    for (int i = 0; i < activeEnemies; i += 5)
-                    {
-                        enemy[i].enemySprite = LoadTexture("Assets/NinjaAdventure/Actor/Monsters/Reptile.png");
-                        enemy[i].life = 3;
-                        enemy[i].type = 3;
-                        enemy[i].enemyDest.width = 32;
-                        enemy[i].enemyDest.height = 32;
-                    }
-
-                    for (int i = 1; i < activeEnemies; i += 5)
-                    {
-                        enemy[i].enemySprite = LoadTexture("Assets/NinjaAdventure/Actor/Monsters/Cyclope/SpriteSheet.png");
-                        enemy[i].life = 2;
-                        enemy[i].type = 2;
-                        enemy[i].enemyDest.width = 16;
-                        enemy[i].enemyDest.height = 16;
-                    }
-
-                    for (int i = 2; i < activeEnemies; i += 5)
-                    {
-                        enemy[i].enemySprite = LoadTexture("Assets/NinjaAdventure/Actor/Monsters/Flam/SpriteSheet.png");
-                        enemy[i].life = 1;
-                        enemy[i].type = 1;
-                        enemy[i].enemyDest.width = 16;
-                        enemy[i].enemyDest.height = 16;
-                    }
-
-                    for (int i = 3; i < activeEnemies; i += 5)
-                    {
-                        enemy[i].enemySprite = LoadTexture("Assets/NinjaAdventure/Actor/Monsters/Flam2/SpriteSheet.png");
-                        enemy[i].life = 1;
-                        enemy[i].type = 1;
-                        enemy[i].enemyDest.width = 16;
-                        enemy[i].enemyDest.height = 16;
-                    }
-
-                    for (int i = 4; i < activeEnemies; i += 5)
-                    {
-                        enemy[i].enemySprite = LoadTexture("Assets/NinjaAdventure/Actor/Monsters/Snake.png");
-                        enemy[i].life = 1;
-                        enemy[i].type = 1;
-                    }
-
-                    load = false;
-                }
+        for (int i = 0; i < game.shootCount; i++)
+        {
+            const Shoot *shoot = &game.shoot[i];
 
-                if (!smooth)
-                {
-                    alpha += 0.02f;
+            // Draw Shuriken (character basic atk)
+            if (shoot->active)
+                DrawSprite(ATLAS_SHURIKEN, shoot->shootSrc, InterpolateRec(shoot->rec, shoot->prev.x, shoot->prev.y), shoot->origin, LAYER_SHOOTS);
+        }
 
-                    if (alpha >= 1.0f)
-                        smooth = true;
-                }
+        FlushSprites();
 
-                if (smooth)
-                    alpha -= 0.02f;
+        const char *waveTitle = game.waveTable->waves[game.wave].title;
 
-                if (enemiesKill == activeEnemies)
-                {
-                    enemiesKill = 0;
-                    for (int i = 0; i < activeEnemies; i++)
-                    {
-                        if (!enemy[i].active)
-                            enemy[i].active = true;
-                    }
-
-                    activeEnemies = SURVIVE_WAVE;
-                    wave = SURVIVE;
-                    smooth = false;
-                    load = true;
-                    alpha = 0.0f;
-                }
-            }
-            break;
+        if (waveTitle[0] != '\0')
+            DrawCachedText(waveTitle, screenWidth / 2 - MeasureCachedText(waveTitle, 40) / 2, screenHeight / 2 - 40, 40, Fade(RAYWHITE, game.alpha));
 
-            default:
-                break;
-            }
+        if (game.victory)
+            DrawCachedText("YOU WIN", screenWidth / 2 - MeasureCachedText("YOU WIN", 40) / 2, screenHeight / 2 - 40, 40, RAYWHITE);
 
-            // Player movement
-            moving = false;
+        if (game.pause)
+            DrawCachedText("GAME PAUSED", screenWidth / 2 - MeasureCachedText("GAME PAUSED", 40) / 2, screenHeight / 2 - 40, 40, GRAY);
 
-            if (alive)
-            {
-                if (IsKeyDown(KEY_UP) && IsKeyDown(KEY_LEFT))
-                {
-                    if (canWalkU && canWalkL)
-                    {
-                        player.playerDest.x -= player.speed.x;
-                        player.playerDest.y -= player.speed.y;
-                    }
-
-                    direction = 7;
-                    dirImg = 1;
-                    moving = true;
-                }
-
-                else if (IsKeyDown(KEY_UP) && IsKeyDown(KEY_RIGHT))
-                {
-                    if (canWalkU && canWalkR)
-                    {
-                        player.playerDest.x += player.speed.x;
-                        player.playerDest.y -= player.speed.y;
-                    }
-                    direction = 6;
-                    dirImg = 1;
-                    moving = true;
-                }
-
-                else if (IsKeyDown(KEY_DOWN) && IsKeyDown(KEY_LEFT))
-                {
-                    if (canWalkD && canWalkL)
-                    {
-                        player.playerDest.x -= player.speed.x;
-                        player.playerDest.y += player.speed.y;
-                    }
-                    direction = 5;
-                    dirImg = 0;
-                    moving = true;
-                }
-
-                else if (IsKeyDown(KEY_DOWN) && IsKeyDown(KEY_RIGHT))
-                {
-                    if (canWalkD && canWalkR)
-                    {
-                        player.playerDest.x += player.speed.x;
-                        player.playerDest.y += player.speed.y;
-                    }
-                    direction = 4;
-                    dirImg = 0;
-                    moving = true;
-                }
-
-                else if (IsKeyDown(KEY_RIGHT))
-                {
-                    if (canWalkR)
-                        player.playerDest.x += player.speed.x;
-
-                    direction = 3;
-                    dirImg = 3;
-                    moving = true;
-                }
-
-                else if (IsKeyDown(KEY_LEFT))
-                {
-                    if (canWalkL)
-                        player.playerDest.x -= player.speed.x;
-
-                    direction = 2;
-                    dirImg = 2;
-                    moving = true;
-                }
-
-                else if (IsKeyDown(KEY_UP))
-                {
-                    if (canWalkU)
-                        player.playerDest.y -= player.speed.y;
-
-                    direction = 1;
-                    dirImg = 1;
-                    moving = true;
-                }
-
-                else if (IsKeyDown(KEY_DOWN))
-                {
-                    if (canWalkD)
-                        player.playerDest.y += player.speed.y;
-
-                    direction = 0;
-                    dirImg = 0;
-                    moving = true;
-                }
-            }
-
-            /*
-            Vector2 p;
-            Vector2 q;
-
-            switch (direction)
-            {
-                case 0:
-                    p.x = player.playerDest.x;
-                    p.y = player.playerDest.y + player.playerDest.height/2 + 10;
-                    break;
-
-                case 1:
-                    p.x = player.playerDest.x;
-                    p.y = player.playerDest.y - player.playerDest.height/2 - 10;
-                    break;
-
-                case 2:
-                    p.x = player.playerDest.x - player.playerDest.width/2 - 10;
-                    p.y = player.playerDest.y;
-                    break;
-
-                case 3:
-                    p.x = player.playerDest.x + player.playerDest.width/2 + 10;
-                    p.y = player.playerDest.y;
-                    break;
-
-                case 4:
-                    p.x = player.playerDest.x + player.playerDest.width/2 + 10;
-                    p.y = player.playerDest.y + player.playerDest.height/2 + 10;
-                    q.x = player.playerDest.x;
-                    q.y = player.playerDest.y + player.playerDest.height/2 + 10;
-                    break;
-
-                case 5:
-                    p.x = player.playerDest.x - player.playerDest.width/2 - 10;
-                    p.y = player.playerDest.y + player.playerDest.height/2 + 10;
-                    q.x = player.playerDest.x;
-                    q.y = player.playerDest.y + player.playerDest.height/2 + 10;
-                    break;
-
-                case 6:
-                    p.x = player.playerDest.x + player.playerDest.width/2 + 10;
-                    p.y = player.playerDest.y - player.playerDest.height/2 - 10;
-                    q.x = player.playerDest.x;
-                    q.y = player.playerDest.y - player.playerDest.height/2 - 10;
-                    break;
-
-                case 7:
-                    p.x = player.playerDest.x - player.playerDest.width/2 - 10;
-                    p.y = player.playerDest.y - player.playerDest.height/2 - 10;
-                    q.x = player.playerDest.x;
-                    q.y = player.playerDest.y - player.playerDest.height/2 - 10;
-                    break;
-
-                default: break;
-            }
-
-            // Map collision behaviour
-            if (CheckCollisionPointRec(p, statue) || CheckCollisionPointRec(q, statue))
-            {
-                switch (direction)
-                {
-                    case 0:
-                    case 4:
-                    case 5: canWalkD = false;
-                            canWalkU = true;
-                            canWalkL = true;
-                            canWalkR = true;
-                            break;
-
-                    case 1:
-                    case 6:
-                    case 7: canWalkU = false;
-                            canWalkD = true;
-                            canWalkL = true;
-                            canWalkR = true;
-                            break;
-
-                    case 2: canWalkL = false;
-                            canWalkD = true;
-                            canWalkU = true;
-                            canWalkR = true;
-                            break;
-
-                    case 3: canWalkR = false;
-                            canWalkD = true;
-                            canWalkU = true;
-                            canWalkL = true;
-                            break;
-
-                    default: break;
-                }
-            }
-            else
-            {
-                canWalkD = true;
-                canWalkU = true;
-                canWalkL = true;
-                canWalkR = true;
-            }
-            */
-
-            // In case the player is moving diagonaly and stop, shoot won't bug
-            if (!moving)
-            {
-                if (direction == 4 || direction == 5)
-                    direction = 0;
-
-                if (direction == 6 || direction == 7)
-                    direction = 1;
-            }
-
-            // Player's movement animation
-            player.playerSrc.y = 0;
-
-            if (moving)
-            {
-                if (frameCount % 10 == 1)
-                    playerFrame++;
-
-                player.playerSrc.y = player.playerSrc.width * playerFrame;
-            }
-
-            // Reset the animation
-            if (playerFrame > 3)
-                playerFrame = 0;
-
-            player.playerSrc.x = player.playerSrc.width * dirImg;
-
-            // Player collision with enemy
-            for (int i = 0; i < activeEnemies; i++)
-            {
-                if (alive)
-                {
-                    if (CheckCollisionRecs(player.playerDest, enemy[i].enemyDest) && colision)
-                    {
-                        playerLife[lifeCount - 1].lifeSrc.x = (playerLife[lifeCount - 1].lifeSrc.width * 4) - 0.8;
-                        PlaySound(damageTaken.sound);
-                        lifeCount--;
-                        colision = false;
-                        damageAnim = true;
-                        damageAnimCount = 0;
-                        invencibleCount = 0;
-                    }
-
-                    // Damage "animation" indicator
-                    if (damageAnim)
-                    {
-                        if (damageAnimCount == 0 || damageAnimCount == 200)
-                        {
-                            player.playerSprite = LoadTexture("Assets/NinjaAdventure/Actor/Characters/GreenNinja/SeparateAnim/Damage.png");
-                        }
-                        else if (damageAnimCount == 100 || damageAnimCount == 300)
-                        {
-                            player.playerSprite = LoadTexture("Assets/NinjaAdventure/Actor/Characters/GreenNinja/SeparateAnim/walk.png");
-                        }
-
-                        damageAnimCount++;
-
-                        if (damageAnimCount > 300)
-                        {
-                            damageAnim = false;
-                            damageAnimCount = 0;
-                        }
-                    }
-
-                    // Player can't take damage while "invencible" is activated
-                    invencibleCount++;
-                    if (invencibleCount > 300)
-                    {
-                        colision = true;
-                    }
-                }
-
-                // When player is dead
-                if (lifeCount == 0)
-                {
-                    StopMusicStream(backgroundMusic.song);
-
-                    player.playerSprite = LoadTexture("Assets/NinjaAdventure/Actor/Characters/GreenNinja/SeparateAnim/Dead.png");
-                    player.playerSrc.x = 0;
-                    player.playerSrc.y = 0;
-                    alive = false;
-
-                    PlaySound(gameOverSound.sound);
-
-                    timerCount++;
-
-                    if (timerCount > 500)
-                    {
-                        gameOver = true;
-                    }
-                }
-            }
-
-            // Initial right enemy behaviour
-            for (int i = 0; i < activeEnemies; i += 4)
-            {
-                if (enemy[i].active)
-                {
-                    if (enemy[i].enemyDest.x > GetScreenWidth() - 25)
-                        enemy[i].enemyDest.x -= enemy[i].speed.x;
-                    if (enemy[i].enemyDest.x <= GetScreenWidth() - 25)
-                        enemy[i].free = true;
-                }
-            }
-
-            // Initial left enemy behaviour
-            for (int i = 1; i < activeEnemies; i += 4)
-            {
-                if (enemy[i].active)
-                {
-                    if (enemy[i].enemyDest.x < 25)
-                        enemy[i].enemyDest.x += enemy[i].speed.x;
-
-                    if (enemy[i].enemyDest.x >= 25)
-                        enemy[i].free = true;
-                }
-            }
-
-            // Initial bottom enemy behaviour
-            for (int i = 2; i < activeEnemies; i += 4)
-            {
-                if (enemy[i].active)
-                {
-                    if (enemy[i].enemyDest.y > GetScreenHeight() - 25)
-                        enemy[i].enemyDest.y -= enemy[i].speed.y;
-                    if (enemy[i].enemyDest.y <= GetScreenHeight() - 25)
-                        enemy[i].free = true;
-                }
-            }
-
-            // Initial top enemy behavior
-            for (int i = 3; i < activeEnemies; i += 4)
-            {
-                if (enemy[i].active)
-                {
-                    if (enemy[i].enemyDest.y < 25)
-                        enemy[i].enemyDest.y += enemy[i].speed.y;
-                    if (enemy[i].enemyDest.y >= 25)
-                        enemy[i].free = true;
-                }
-            }
-
-            // General enemy behaviour (follow player)
-            for (int i = 0; i < activeEnemies; i++)
-            {
-                int indice;
-                enemy[i].collided = false;
-
-                for (int j = 0; j < activeEnemies; j++)
-                {
-                    if (i != j)
-                    {
-                        if (CheckCollisionRecs(enemy[i].enemyDest, enemy[j].enemyDest))
-                        {
-                            enemy[i].collided = true;
-                            indice = j;
-                        }
-                    }
-                }
-
-                bool yMenor = true;
-                bool yMaior = true;
-                if (enemy[i].active && enemy[i].free && !enemy[i].collided)
-                {
-                    if (player.playerDest.x < enemy[i].enemyDest.x)
-                    {
-                        enemy[i].enemyDest.x -= enemy[i].speed.x;
-                    }
-
-                    if (player.playerDest.x > enemy[i].enemyDest.x)
-                    {
-                        enemy[i].enemyDest.x += enemy[i].speed.x;
-                    }
-
-                    if (player.playerDest.y < enemy[i].enemyDest.y)
-                    {
-                        enemy[i].enemyDest.y -= enemy[i].speed.y;
-                        enemy[i].enemyDir = 1; // Top
-                    }
-                    else
-                    {
-                        yMenor = false;
-                    }
-
-                    if (player.playerDest.y > enemy[i].enemyDest.y)
-                    {
-                        enemy[i].enemyDest.y += enemy[i].speed.y;
-                        enemy[i].enemyDir = 0; // Bottom
-                    }
-                    else
-                    {
-                        yMaior = false;
-                    }
-
-                    // For horizonatal animation
-                    if (!yMenor && !yMaior)
-                    {
-                        if (player.playerDest.x < enemy[i].enemyDest.x)
-                            enemy[i].enemyDir = 2; // Left
-
-                        if (player.playerDest.x > enemy[i].enemyDest.x)
-                            enemy[i].enemyDir = 3; // Right
-                    }
-                }
-                else if (enemy[i].active && enemy[i].free && enemy[i].collided)
-                {
-                    if (enemy[i].enemyDest.x < enemy[indice].enemyDest.x)
-                    {
-                        enemy[i].enemyDest.x -= enemy[i].speed.x;
-                    }
-
-                    if (enemy[i].enemyDest.x > enemy[indice].enemyDest.x)
-                    {
-                        enemy[i].enemyDest.x += enemy[i].speed.x;
-                    }
-
-                    if (enemy[i].enemyDest.y < enemy[indice].enemyDest.y)
-                    {
-                        enemy[i].enemyDest.y -= enemy[i].speed.y;
-                    }
-
-                    if (enemy[i].enemyDest.y > enemy[indice].enemyDest.y)
-                    {
-                        enemy[i].enemyDest.y += enemy[i].speed.y;
-                    }
-                }
-            }
-
-            // Enemy movement animation
-            for (int i = 0; i < activeEnemies; i++)
-            {
-                enemy[i].enemySrc.y = 0;
-
-                if (enemy[i].active)
-                {
-                    if (frameCount % 10 == 1)
-                        enemy[i].enemyFrame++;
-
-                    enemy[i].enemySrc.y = enemy[i].enemySrc.height * enemy[i].enemyFrame;
-                }
-
-                // Reset the animation
-                if (enemy[i].enemyFrame > 3)
-                    enemy[i].enemyFrame = 0;
-
-                enemy[i].enemySrc.x = enemy[i].enemySrc.width * enemy[i].enemyDir;
-            }
-
-            // Wall behaviour
-            if (player.playerDest.x - player.playerDest.width / 2 <= 0)
-                player.playerDest.x = player.playerDest.width / 2;
-            if (player.playerDest.x + player.playerDest.width / 2 >= GetScreenWidth())
-                player.playerDest.x = GetScreenWidth() - player.playerDest.width / 2;
-            if (player.playerDest.y - player.playerDest.height / 2 <= 0)
-                player.playerDest.y = player.playerDest.height / 2;
-            if (player.playerDest.y + player.playerDest.height / 2 >= GetScreenHeight())
-                player.playerDest.y = GetScreenHeight() - player.playerDest.height / 2;
-
-            // Shadow behaviour
-            shadow.playerDest.x = player.playerDest.x;
-            shadow.playerDest.y = player.playerDest.y + 14;
-
-            // Shoot initialization
-            if (IsKeyDown(KEY_SPACE))
-            {
-                shootRate += 2;
-
-                for (int i = 0; i < NUM_SHOOTS; i++)
-                {
-                    if (!shoot[i].active && shootRate % 40 == 0)
-                    {
-                        shoot[i].rec.x = player.playerDest.x;
-                        shoot[i].rec.y = player.playerDest.y + 10;
-                        shoot[i].active = true;
-
-                        // Bullet Movement
-                        // Using variable direction to see where's the player shooting.
-                        // Using bulletDirection to define where's the bullet going.
-
-                        switch (direction)
-                        {
-                        case 7:
-                            shoot[i].bulletDirection = 7;
-                            break;
-
-                        case 6:
-                            shoot[i].bulletDirection = 6;
-                            break;
-
-                        case 5:
-                            shoot[i].bulletDirection = 5;
-                            break;
-
-                        case 4:
-                            shoot[i].bulletDirection = 4;
-                            break;
-
-                        case 3:
-                            shoot[i].bulletDirection = 3;
-                            break;
-
-                        case 2:
-                            shoot[i].bulletDirection = 2;
-                            break;
-
-                        case 1:
-                            shoot[i].bulletDirection = 1;
-                            break;
-
-                        case 0:
-                            shoot[i].bulletDirection = 0;
-                            break;
-
-                        default:
-                            break;
-                        }
-
-                        break;
-                    }
-                }
-            }
-
-            // Shoot logic
-            for (int i = 0; i < NUM_SHOOTS; i++)
-            {
-                if (shoot[i].active)
-                {
-                    // Shuriken throw animation
-                    if (frameCount % 4 == 0)
-                    {
-                        shoot[i].shootSrc.x = shoot[i].bulletFrame * 16;
-                        shoot[i].bulletFrame++;
-
-                        if (shoot[i].bulletFrame > 1)
-                            shoot[i].bulletFrame = 0;
-                    }
-
-                    // bulletDirection:
-                    switch (shoot[i].bulletDirection)
-                    {
-                    // [Top-Left]
-                    case 7:
-                        shoot[i].rec.x -= shoot[i].speed.x;
-                        shoot[i].rec.y -= shoot[i].speed.y;
-                        break;
-
-                    // [Top-Right]
-                    case 6:
-                        shoot[i].rec.x += shoot[i].speed.x;
-                        shoot[i].rec.y -= shoot[i].speed.y;
-                        break;
-
-                    // [Bottom-Left]
-                    case 5:
-                        shoot[i].rec.x -= shoot[i].speed.x;
-                        shoot[i].rec.y += shoot[i].speed.y;
-                        break;
-
-                    // [Bottom-Right]
-                    case 4:
-                        shoot[i].rec.x += shoot[i].speed.x;
-                        shoot[i].rec.y += shoot[i].speed.y;
-                        break;
-
-                    // [Right]
-                    case 3:
-                        shoot[i].rec.x += shoot[i].speed.x;
-                        break;
-
-                    // [Left]
-                    case 2:
-                        shoot[i].rec.x -= shoot[i].speed.x;
-                        break;
-
-                    // [Top]
-                    case 1:
-                        shoot[i].rec.y -= shoot[i].speed.y;
-                        break;
-
-                    // [Bottom]
-                    case 0:
-                        shoot[i].rec.y += shoot[i].speed.y;
-                        break;
-
-                    default:
-                        break;
-                    }
-
-                    // Collision with enemy
-                    for (int j = 0; j < activeEnemies; j++)
-                    {
-                        if (enemy[j].active)
-                        {
-                            if (CheckCollisionRecs(shoot[i].rec, enemy[j].enemyDest))
-                            {
-                                PlaySound(damageDone.sound);
-                                shoot[i].active = false;
-                                enemy[j].life--;
-
-                                if (enemy[j].life == 0)
-                                {
-                                    if (j % 4 == 0)
-                                    {
-                                        enemy[j].enemyDest.x = GetRandomValue(GetScreenWidth(), GetScreenWidth() + 1000);
-                                        enemy[j].enemyDest.y = GetRandomValue(0, GetScreenHeight() - enemy[i].enemyDest.height);
-                                        enemy[j].active = false;
-                                    }
-
-                                    else if (j % 4 == 1)
-                                    {
-                                        enemy[j].enemyDest.x = GetRandomValue(-1000, 0);
-                                        enemy[j].enemyDest.y = GetRandomValue(0, GetScreenHeight() - enemy[i].enemyDest.height);
-                                        enemy[j].active = false;
-                                    }
-
-                                    else if (j % 4 == 2)
-                                    {
-                                        enemy[j].enemyDest.x = GetRandomValue(0, GetScreenWidth() - enemy[i].enemyDest.width);
-                                        enemy[j].enemyDest.y = GetRandomValue(GetScreenHeight(), GetScreenHeight() + 1000);
-                                        enemy[j].active = false;
-                                    }
-
-                                    else if (j % 4 == 3)
-                                    {
-                                        enemy[j].enemyDest.x = GetRandomValue(0, GetScreenWidth() - enemy[i].enemyDest.width);
-                                        enemy[j].enemyDest.y = GetRandomValue(-1000, 0);
-                                        enemy[j].active = false;
-                                    }
-
-                                    // Restore life
-                                    switch (enemy[j].type)
-                                    {
-                                    case 1:
-                                        enemy[j].life = 1;
-                                        break;
-
-                                    case 2:
-                                        enemy[j].life = 2;
-                                        break;
-
-                                    case 3:
-                                        enemy[j].life = 3;
-                                        break;
-
-                                    default:
-                                        break;
-                                    }
-
-                                    enemiesKill++;
-                                    score += 100;
-                                }
-                                // shootRate = 0;
-                            }
-
-                            if (shoot[i].rec.x >= GetScreenWidth())
-                            {
-                                shoot[i].active = false;
-                                // shootRate = 0;
-                            }
-
-                            if (shoot[i].rec.x < -shoot[i].rec.width)
-                            {
-                                shoot[i].active = false;
-                                // shootRate = 0;
-                            }
-
-                            if (shoot[i].rec.y < -shoot[i].rec.height)
-                            {
-                                shoot[i].active = false;
-                                // shootRate = 0;
-                            }
-
-                            if (shoot[i].rec.y >= GetScreenHeight())
-                            {
-                                shoot[i].active = false;
-                                // shootRate = 0;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    else
-    {
-        if (IsKeyPressed(KEY_ENTER))
+        if (rulesOpen)
         {
-            InitGame();
-            gameOver = false;
+            DrawRectangle(0, 0, screenWidth, screenHeight, CLITERAL(Color){0, 0, 0, 160});
+            DrawTexturePro(rules, (Rectangle){0, 0, 415, 618}, (Rectangle){screenWidth / 2, screenHeight / 2, 415, 618}, (Vector2){207.5, 309}, 0, WHITE);
         }
     }
+
+    PROFILE_END(PROFILE_ZONE_DRAW);
+
+    // Counted before the overlay so it doesn't measure itself
+    PROFILE_SET(PROFILE_COUNTER_BATCHES, GetSpriteBatchCount());
+    PROFILE_SET(PROFILE_COUNTER_VERTICES, GetSpriteVertexCount());
+    PROFILE_SET(PROFILE_COUNTER_TEXTURES, CountCachedTextures());
+    PROFILE_SET(PROFILE_COUNTER_ENEMIES, game.enemies.count - game.deadEnemies);
+    PROFILE_SET(PROFILE_COUNTER_SHOOTS, game.shootCount);
+    PROFILE_SET(PROFILE_COUNTER_RENDER_SCALE, (int)(GetFrameTargetScale() * 100));
+    PROFILE_SET(PROFILE_COUNTER_VOICES, GetSfxVoicesPlaying());
 }
 
-//------------------------------------------------------------------------------------
-// Draw game (one frame)
-//------------------------------------------------------------------------------------
-void DrawGame(void)
+// Render the background and the HUD into their cached layers when they are out of date
+static void DrawCachedLayers(void)
 {
-    ClearBackground(DARKGRAY);
-
-    if (!gameOver)
+    if (game.score != hudScore || game.lifeCount != hudLifeCount)
     {
-        DrawTexturePro(backgroundMain, bgSrc, bgDest, bgOrigin, 0, WHITE);
+        hudScore = game.score;
+        hudLifeCount = game.lifeCount;
+        InvalidateCachedLayer(CACHED_HUD);
+    }
 
-        // Rectangle for tracking character position (testes!)
-        // DrawRectangle(player.playerDest.x, player.playerDest.y, player.playerDest.width, player.playerDest.height, BLUE);
-        DrawTexturePro(shadow.playerSprite, shadow.playerSrc, shadow.playerDest, shadow.origin, 0, WHITE);
-        DrawTexturePro(player.playerSprite, player.playerSrc, player.playerDest, player.origin, 0, WHITE);
+    if (BeginCachedLayer(CACHED_BACKGROUND, screenWidth, screenHeight))
+    {
+        QueueSprite(backgroundMain, bgSrc, bgDest, bgOrigin, LAYER_BACKGROUND, WHITE);
+        EndCachedLayer();
+    }
 
+    if (BeginCachedLayer(CACHED_HUD, screenWidth, screenHeight))
+    {
         // Draw player's life
-        DrawTexturePro(playerLife[0].life, playerLife[0].lifeSrc, playerLife[0].lifeDest, playerLife[0].origin, 0, WHITE);
-        DrawTexturePro(playerLife[1].life, playerLife[1].lifeSrc, playerLife[1].lifeDest, playerLife[1].origin, 0, WHITE);
-        DrawTexturePro(playerLife[2].life, playerLife[2].lifeSrc, playerLife[2].lifeDest, playerLife[2].origin, 0, WHITE);
-
-        if (wave == FIRST)
-            DrawText("FIRST WAVE", GetScreenWidth() / 2 - MeasureText("FIRST WAVE", 40) / 2, GetScreenHeight() / 2 - 40, 40, Fade(RAYWHITE, alpha));
-        else if (wave == SECOND)
-            DrawText("SECOND WAVE", GetScreenWidth() / 2 - MeasureText("SECOND WAVE", 40) / 2, GetScreenHeight() / 2 - 40, 40, Fade(RAYWHITE, alpha));
-        else if (wave == THIRD)
-            DrawText("THIRD WAVE", GetScreenWidth() / 2 - MeasureText("THIRD WAVE", 40) / 2, GetScreenHeight() / 2 - 40, 40, Fade(RAYWHITE, alpha));
-        else if (wave == BOSS)
-            DrawText("SURVIVE!", GetScreenWidth() / 2 - MeasureText("SURVIVE!", 40) / 2, GetScreenHeight() / 2 - 40, 40, Fade(RAYWHITE, alpha));
-
-        for (int i = 0; i < activeEnemies; i++)
-        {
-            if (enemy[i].active)
-                DrawTexturePro(enemy[i].enemySprite, enemy[i].enemySrc, enemy[i].enemyDest, enemy[i].origin, 0, WHITE);
-        }
-
-        for (int i = 0; i < NUM_SHOOTS; i++)
-        {
-            // Draw Shuriken (character basic atk)
-            if (shoot[i].active)
-                DrawTexturePro(shoot[i].shootSprite, shoot[i].shootSrc, shoot[i].rec, shoot[i].origin, 0, WHITE);
-        }
-
-        DrawText(TextFormat("%04i", score), 40, 40, 40, RAYWHITE);
+        DrawSprite(ATLAS_HEART, playerLife[0].lifeSrc, playerLife[0].lifeDest, playerLife[0].origin, LAYER_HUD);
+        DrawSprite(ATLAS_HEART, playerLife[1].lifeSrc, playerLife[1].lifeDest, playerLife[1].origin, LAYER_HUD);
+        DrawSprite(ATLAS_HEART, playerLife[2].lifeSrc, playerLife[2].lifeDest, playerLife[2].origin, LAYER_HUD);
 
-        if (victory)
-            DrawText("YOU WIN", GetScreenWidth() / 2 - MeasureText("YOU WIN", 40) / 2, GetScreenHeight() / 2 - 40, 40, RAYWHITE);
-
-        if (pause)
-            DrawText("GAME PAUSED", GetScreenWidth() / 2 - MeasureText("GAME PAUSED", 40) / 2, GetScreenHeight() / 2 - 40, 40, GRAY);
-
-        if (rulesOpen)
-        {
-            DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), CLITERAL(Color){0, 0, 0, 160});
-            DrawTexturePro(rules, (Rectangle){0, 0, 415, 618}, (Rectangle){GetScreenWidth() / 2, GetScreenHeight() / 2, 415, 618}, (Vector2){207.5, 309}, 0, WHITE);
-        }
+        DrawText(TextFormat("%04i", game.score), 40, 40, 40, RAYWHITE);
+        EndCachedLayer();
     }
 }
 
@@ -1752,14 +852,13 @@ void DrawGame(void)
 //------------------------------------------------------------------------------------
 void UpdateLogo(void)
 {
-    bgDest.width = GetScreenWidth();
-    bgDest.height = GetScreenHeight();
+    bgDest.width = screenWidth;
+    bgDest.height = screenHeight;
     bgSrc.width = 890;
     bgSrc.height = 470;
 
     // Background music for logo screen
-    UpdateMusicStream(backgroundMenu.song);
-    PlayMusicStream(backgroundMenu.song);
+    PlaySong(&backgroundMenu.song);
 }
 
 //------------------------------------------------------------------------------------
@@ -1775,20 +874,26 @@ void DrawLogo(void)
 //------------------------------------------------------------------------------------
 void UpdateTitle(void)
 {
-    bgDest.width = GetScreenWidth();
-    bgDest.height = GetScreenHeight();
+    bgDest.width = screenWidth;
+    bgDest.height = screenHeight;
     bgSrc.width = 890;
     bgSrc.height = 470;
 
     // Keeps the music playing
-    UpdateMusicStream(backgroundMenu.song);
-    PlayMusicStream(backgroundMenu.song);
+    PlaySong(&backgroundMenu.song);
+
+    // InitGame() may have run before the loader uploaded the buttons
+    if (button.id == 0)
+        button = buttonIdle;
+
+    if (buttonCredits.id == 0)
+        buttonCredits = creditsIdle;
 
-    btnBounds.x = GetScreenWidth() / 1.985 - button.width / 2;
-    btnBounds.y = GetScreenHeight() / 1.65 + button.height / 2;
+    btnBounds.x = screenWidth / 1.985 - button.width / 2;
+    btnBounds.y = screenHeight / 1.65 + button.height / 2;
 
-    creditsBounds.x = GetScreenWidth() - 75;
-    creditsBounds.y = GetScreenHeight() - 75;
+    creditsBounds.x = screenWidth - 75;
+    creditsBounds.y = screenHeight - 75;
 
     mousePoint = GetMousePosition();
     btnAction = false;
@@ -1799,15 +904,15 @@ void UpdateTitle(void)
     {
         if (IsMouseButtonDown(MOUSE_BUTTON_LEFT))
         {
-            button = LoadTexture("Assets/NinjaAdventure/HUD/play_d.png");
+            button = buttonDown;
         }
 
-        if (IsMouseButtonReleased(MOUSE_BUTTON_LEFT))
+        if (LatchedMouseButtonReleased(MOUSE_BUTTON_LEFT))
             btnAction = true;
     }
     else
     {
-        button = LoadTexture("Assets/NinjaAdventure/HUD/play_c.png");
+        button = buttonIdle;
     }
 
     // Check credits button state
@@ -1815,15 +920,15 @@ void UpdateTitle(void)
     {
         if (IsMouseButtonDown(MOUSE_BUTTON_LEFT) && !opened)
         {
-            buttonCredits = LoadTexture("Assets/NinjaAdventure/HUD/credits_d.png");
+            buttonCredits = creditsDown;
         }
 
-        if (IsMouseButtonReleased(MOUSE_BUTTON_LEFT))
+        if (LatchedMouseButtonReleased(MOUSE_BUTTON_LEFT))
             btnActionCredits = true;
     }
     else
     {
-        buttonCredits = LoadTexture("Assets/NinjaAdventure/HUD/credits_a.png");
+        buttonCredits = creditsIdle;
     }
 
     if (btnAction)
@@ -1832,7 +937,7 @@ void UpdateTitle(void)
         isPressed = true;
         rulesOpen = true;
         InitGame();
-        gameOver = false;
+        game.gameOver = false;
     }
 
     if (btnActionCredits && !opened)
@@ -1845,7 +950,7 @@ void UpdateTitle(void)
     // Close credits
     if (CheckCollisionPointRec(mousePoint, (Rectangle){1010, 205, 13, 13}))
     {
-        if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT))
+        if (LatchedMouseButtonPressed(MOUSE_BUTTON_LEFT))
         {
             isPressedCredits = false;
             opened = false;
@@ -1866,8 +971,8 @@ void DrawTitle(void)
 
     if (isPressedCredits)
     {
-        DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), CLITERAL(Color){0, 0, 0, 100});
-        DrawTexturePro(credits, (Rectangle){0, 0, 500, 540}, (Rectangle){GetScreenWidth() / 2, GetScreenHeight() / 2, 500, 540}, (Vector2){250, 270}, 0, WHITE);
+        DrawRectangle(0, 0, screenWidth, screenHeight, CLITERAL(Color){0, 0, 0, 100});
+        DrawTexturePro(credits, (Rectangle){0, 0, 500, 540}, (Rectangle){screenWidth / 2, screenHeight / 2, 500, 540}, (Vector2){250, 270}, 0, WHITE);
     }
 }
 
@@ -1876,11 +981,12 @@ void DrawTitle(void)
 //------------------------------------------------------------------------------------
 void UpdateNarrative(void)
 {
+    // The fade from black runs on ticks, at the same speed whatever the refresh rate
+    countNarrative--;
 
-    UpdateMusicStream(narrativeMusic.song);
-    PlayMusicStream(narrativeMusic.song);
+    PlaySong(&narrativeMusic.song);
 
-    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT))
+    if (LatchedMouseButtonPressed(MOUSE_BUTTON_LEFT))
     {
         narrativeScreen++;
         PlaySound(continueNarrative.sound);
@@ -1892,12 +998,11 @@ void UpdateNarrative(void)
 //------------------------------------------------------------------------------------
 void DrawNarrative(void)
 {
-    DrawTexturePro(narrative, (Rectangle){0, 900 * narrativeScreen, 1600, 900}, (Rectangle){0, 0, GetScreenWidth(), GetScreenHeight()}, (Vector2){0, 0}, 0, WHITE);
+    DrawTexturePro(narrative, (Rectangle){0, 900 * narrativeScreen, 1600, 900}, (Rectangle){0, 0, screenWidth, screenHeight}, (Vector2){0, 0}, 0, WHITE);
 
-    countNarrative -= 0.1;
     if (countNarrative >= 0)
     {
-        DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), CLITERAL(Color){23, 29, 23, countNarrative});
+        DrawRectangle(0, 0, screenWidth, screenHeight, CLITERAL(Color){23, 29, 23, countNarrative});
     }
 }
 
@@ -1908,6 +1013,13 @@ void DrawScreen()
 {
     BeginDrawing();
 
+    // Background and HUD are only redrawn when they change, their render textures can't
+    // be drawn into while the frame target is bound
+    if (currentScreen == GAMEPLAY && !game.gameOver)
+        DrawCachedLayers();
+
+    BeginFrameTarget();
+
     ClearBackground(RAYWHITE);
 
     switch (currentScreen)
@@ -1938,10 +1050,23 @@ void DrawScreen()
         // TODO: Create and Instantiate drawEnding function;
     }
     break;
+    case LOADING:
+    {
+        DrawLoading();
+    }
+    break;
     default:
         break;
     }
 
+    EndFrameTarget();
+
+    // At window resolution, so it stays readable when the frame target shrinks
+    if (currentScreen == GAMEPLAY)
+        PROFILE_DRAW();
+
+    frameBusy = (float)(GetTime() - frameStart);
+
     EndDrawing();
 }
 
@@ -1951,81 +1076,707 @@ void DrawScreen()
 void UnloadGame(void)
 {
     // TODO: Unload all dynamic loaded data (textures, sounds, models...)
-    UnloadTexture(player.playerSprite);
-    UnloadTexture(shadow.playerSprite);
-    UnloadTexture(playerLife[0].life);
-    UnloadTexture(playerLife[1].life);
-    UnloadTexture(playerLife[2].life);
-    UnloadTexture(backgroundLogo);
-    UnloadTexture(backgroundTitle);
-    UnloadTexture(backgroundMain);
-    UnloadTexture(narrative);
-    UnloadTexture(credits);
-    UnloadTexture(button);
-    UnloadTexture(rules);
+    UnloadTextureCache();
+    UnloadSpriteQueue();
+    UnloadCachedLayers();
+    UnloadTextCache();
+    UnloadFrameTarget();
+    GameFree(&game);
+    StopMusicPlayer(); // Before the streams it feeds go away
     UnloadMusicStream(backgroundMusic.song);
     UnloadMusicStream(backgroundMenu.song);
     UnloadMusicStream(narrativeMusic.song);
-    UnloadSound(gameOverSound.sound);
-    UnloadSound(damageTaken.sound);
+    UnloadSfx();
+    UnloadSound(continueNarrative.sound);
     UnloadSound(fxButton);
+    StopAssetLoader(); // After the music streams, it frees the memory they played from
 
-    for (int i = 0; i < NUM_SHOOTS; i++)
+    int droppedScores = StopScoreClient();
+
+    if (droppedScores > 0)
+        TraceLog(LOG_WARNING, "RANK: %i scores could not be saved", droppedScores);
+
+    CloseAssetPack(); // Last, packed music and leftovers point into it
+}
+
+//------------------------------------------------------------------------------------
+// Texture cache
+//------------------------------------------------------------------------------------
+// Every texture is loaded through here, keyed by file path, so a sprite used by
+// many entities (or requested every frame) is decoded and uploaded only once.
+// Each AcquireTexture() is paired with a ReleaseTexture(); the texture is unloaded
+// when its last reference goes away, or when UnloadGame() drains the cache.
+Texture2D AcquireTexture(const char *fileName)
+{
+    for (int i = 0; i < textureCacheCapacity; i++)
     {
-        // Unload all shurikens
-        UnloadTexture(shoot[i].shootSprite);
+        if (textureCache[i].refCount > 0 && strcmp(textureCache[i].fileName, fileName) == 0)
+        {
+            textureCache[i].refCount++;
+            return textureCache[i].texture;
+        }
     }
 
-    for (int i = 0; i < NUM_MAX_ENEMIES; i++)
+    Image image = {0};
+
+    if (PackedImage(fileName, &image))
+        return AdoptTexture(fileName, LoadTextureFromImage(image));
+
+    return AdoptTexture(fileName, LoadTexture(fileName));
+}
+
+// Hand a texture uploaded somewhere else (the asset loader) over to the cache,
+// with one reference as if it had been acquired. The path must not be cached yet.
+Texture2D AdoptTexture(const char *fileName, Texture2D texture)
+{
+    // Failed loads are not cached, so a missing file is retried on the next request
+    if (texture.id == 0)
+        return texture;
+
+    int slot = 0;
+
+    while (slot < textureCacheCapacity && textureCache[slot].refCount > 0)
+        slot++;
+
+    // Full: grow like the entity pools, every texture has to be tracked to be released
+    if (slot == textureCacheCapacity)
     {
-        UnloadTexture(enemy[i].enemySprite);
+        int capacity = (textureCacheCapacity == 0) ? NUM_CACHED_TEXTURES : textureCacheCapacity * 2;
+        CachedTexture *grown = (CachedTexture *)realloc(textureCache, (size_t)capacity * sizeof(CachedTexture));
+
+        if (grown != NULL)
+        {
+            memset(grown + textureCacheCapacity, 0, (size_t)(capacity - textureCacheCapacity) * sizeof(CachedTexture));
+            textureCache = grown;
+            textureCacheCapacity = capacity;
+        }
     }
+
+    // A texture the cache can't find again would leak, it is dropped like a failed load
+    if (slot == textureCacheCapacity || strlen(fileName) >= sizeof(textureCache[slot].fileName))
+    {
+        TraceLog(LOG_WARNING, "TEXTURE CACHE: Can't cache [%s], texture unloaded", fileName);
+        UnloadTexture(texture);
+
+        return (Texture2D){0};
+    }
+
+    strcpy(textureCache[slot].fileName, fileName);
+    textureCache[slot].refCount = 1;
+    textureCache[slot].texture = texture;
+
+    return texture;
 }
 
-void scorerank(void)
+void ReleaseTexture(Texture2D texture)
+{
+    if (texture.id == 0)
+        return;
+
+    for (int i = 0; i < textureCacheCapacity; i++)
+    {
+        if (textureCache[i].refCount > 0 && textureCache[i].texture.id == texture.id)
+        {
+            textureCache[i].refCount--;
+
+            if (textureCache[i].refCount == 0)
+            {
+                UnloadTexture(textureCache[i].texture);
+                textureCache[i] = (CachedTexture){0};
+            }
+
+            return;
+        }
+    }
+}
+
+// Point a texture slot to another file, dropping the reference it held before.
+// The new texture is acquired first, so reassigning the same file never reloads it.
+void AssignTexture(Texture2D *slot, const char *fileName)
+{
+    Texture2D texture = AcquireTexture(fileName);
+
+    ReleaseTexture(*slot);
+    *slot = texture;
+}
+
+void UnloadTextureCache(void)
+{
+    for (int i = 0; i < textureCacheCapacity; i++)
+    {
+        if (textureCache[i].refCount > 0)
+            UnloadTexture(textureCache[i].texture);
+    }
+
+    free(textureCache);
+    textureCache = NULL;
+    textureCacheCapacity = 0;
+}
+
+int CountCachedTextures(void)
+{
+    int count = 0;
+
+    for (int i = 0; i < textureCacheCapacity; i++)
+    {
+        if (textureCache[i].refCount > 0)
+            count++;
+    }
+
+    return count;
+}
+
+//------------------------------------------------------------------------------------
+// Asset pack
+//------------------------------------------------------------------------------------
+// The pack holds decoded copies of the assets, these hand them out in place. Nothing they
+// return may be unloaded, it stays valid until CloseAssetPack() at the very end.
+// OpenAssetPack() only checks that entry data lies inside the file, the sizes here make
+// sure the upload reads no more than that. A corrupt or stale entry falls back to the file.
+static bool PackedImageFits(const PackEntry *entry)
+{
+    if (entry->width <= 0 || entry->height <= 0 || entry->width > 16384 || entry->height > 16384 ||
+        entry->mipmaps < 1 || entry->mipmaps > 15 || entry->format < PIXELFORMAT_UNCOMPRESSED_GRAYSCALE ||
+        entry->format > PIXELFORMAT_COMPRESSED_ASTC_8x8_RGBA)
+        return false;
+
+    size_t size = 0;
+    int width = entry->width;
+    int height = entry->height;
+
+    for (int level = 0; level < entry->mipmaps; level++)
+    {
+        size += (size_t)GetPixelDataSize(width, height, entry->format);
+        width = (width > 1) ? width / 2 : 1;
+        height = (height > 1) ? height / 2 : 1;
+    }
+
+    return (size <= entry->dataSize);
+}
+
+static bool PackedWaveFits(const PackEntry *entry)
+{
+    if (entry->width <= 0 || entry->height <= 0 || entry->mipmaps < 1 || entry->mipmaps > 8 ||
+        (entry->format != 8 && entry->format != 16 && entry->format != 32))
+        return false;
+
+    return ((size_t)entry->width * entry->mipmaps * (entry->format / 8) <= entry->dataSize);
+}
+
+static bool PackedImage(const char *fileName, Image *image)
+{
+    const PackEntry *entry = FindPackEntry(fileName);
+
+    if (entry == NULL || entry->type != PACK_IMAGE)
+        return false;
+
+    if (!PackedImageFits(entry))
+    {
+        TraceLog(LOG_WARNING, "PACK: [%s] image entry doesn't match its data, loading the file instead", fileName);
+        return false;
+    }
+
+    // Backgrounds are packed as DXT, without driver support they come from the PNGs instead
+    if (entry->format >= PIXELFORMAT_COMPRESSED_DXT1_RGB && !compressedTexturesSupported)
+        return false;
+
+    *image = (Image){(void *)GetPackEntryData(entry), entry->width, entry->height, entry->mipmaps, entry->format};
+
+    return true;
+}
+
+static bool PackedWave(const char *fileName, Wave *wave)
+{
+    const PackEntry *entry = FindPackEntry(fileName);
+
+    if (entry == NULL || entry->type != PACK_WAVE)
+        return false;
+
+    if (!PackedWaveFits(entry))
+    {
+        TraceLog(LOG_WARNING, "PACK: [%s] wave entry doesn't match its data, loading the file instead", fileName);
+        return false;
+    }
+
+    *wave = (Wave){entry->width, entry->height, entry->format, entry->mipmaps, (void *)GetPackEntryData(entry)};
+
+    return true;
+}
+
+static const unsigned char *PackedFileData(const char *fileName, unsigned int *size)
+{
+    const PackEntry *entry = FindPackEntry(fileName);
+
+    if (entry == NULL || entry->type != PACK_FILE)
+        return NULL;
+
+    *size = entry->dataSize;
+
+    return (const unsigned char *)GetPackEntryData(entry);
+}
+
+// rlgl refuses compressed formats the driver lacks and returns no texture, so try one
+// 4x4 DXT1 block. Needs the GL context, the window icon is never compressed.
+static bool ProbeCompressedTextures(void)
+{
+    unsigned char block[8] = {0};
+    Texture2D probe = LoadTextureFromImage((Image){block, 4, 4, 1, PIXELFORMAT_COMPRESSED_DXT1_RGB});
+
+    UnloadTexture(probe);
+    TraceLog(LOG_INFO, (probe.id != 0) ? "PACK: Compressed textures supported" : "PACK: No DXT support, compressed textures load from loose files");
+
+    return (probe.id != 0);
+}
+
+//------------------------------------------------------------------------------------
+// Asset loader
+//------------------------------------------------------------------------------------
+// A worker thread decodes every file in assetRequests (PNG to Image, WAV to Wave,
+// OGG read into memory) and publishes how far it got through assetsDecoded.
+// Everything that touches the GPU or the audio device (textures, sounds, music
+// streams) is created here on the main thread by UpdateAssetLoader(), a few per frame.
+static void FreeDecodedAsset(DecodedAsset *decoded)
+{
+    if (!decoded->packed)
+    {
+        UnloadImage(decoded->image);
+        UnloadWave(decoded->wave);
+        UnloadFileData(decoded->data);
+    }
+
+    *decoded = (DecodedAsset){0};
+}
+
+static bool IsAssetUsed(int index)
+{
+    switch (assetRequests[index].type)
+    {
+    case ASSET_SPRITE:
+        return !atlasAvailable;
+
+    case ASSET_ATLAS:
+        return atlasAvailable;
+
+    default:
+        return true;
+    }
+}
+
+static bool IsRepeatedAsset(int index)
+{
+    for (int i = 0; i < index; i++)
+    {
+        if (assetRequests[i].type == assetRequests[index].type &&
+            strcmp(assetRequests[i].fileName, assetRequests[index].fileName) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+static void DecodeAsset(int index)
+{
+    const AssetRequest *request = &assetRequests[index];
+    DecodedAsset *decoded = &decodedAssets[index];
+
+    if (!IsAssetUsed(index))
+        return;
+
+    switch (request->type)
+    {
+    case ASSET_TEXTURE:
+    case ASSET_SPRITE:
+    case ASSET_ATLAS:
+        // Shared textures are decoded once, later requests come from the cache
+        if (IsRepeatedAsset(index))
+            break;
+
+        decoded->packed = PackedImage(request->fileName, &decoded->image);
+
+        if (!decoded->packed)
+            decoded->image = LoadImage(request->fileName);
+        break;
+
+    case ASSET_SOUND:
+    case ASSET_SFX:
+        decoded->packed = PackedWave(request->fileName, &decoded->wave);
+
+        if (!decoded->packed)
+            decoded->wave = LoadWave(request->fileName);
+        break;
+
+    case ASSET_MUSIC:
+        decoded->data = (unsigned char *)PackedFileData(request->fileName, &decoded->dataSize);
+        decoded->packed = (decoded->data != NULL);
+
+        if (!decoded->packed)
+            decoded->data = LoadFileData(request->fileName, &decoded->dataSize);
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void UploadAsset(int index)
 {
-    FILE *arq;
-    Playerscore reg = {0};
-    Playerscore temp = {0};
+    const AssetRequest *request = &assetRequests[index];
+    DecodedAsset *decoded = &decodedAssets[index];
 
-    player1.fscore = score;
+    if (!IsAssetUsed(index))
+        return;
 
-    arq = fopen("rankscore.bin", "r+b");
+    switch (request->type)
+    {
+    case ASSET_TEXTURE:
+    case ASSET_SPRITE:
+    case ASSET_ATLAS:
+    {
+        Texture2D *slot = (Texture2D *)request->target;
 
-    if (arq == NULL)
+        if (IsRepeatedAsset(index))
+            *slot = AcquireTexture(request->fileName);
+        else if (decoded->image.data != NULL)
+        {
+            *slot = AdoptTexture(request->fileName, LoadTextureFromImage(decoded->image));
+            FreeDecodedAsset(decoded);
+        }
+    }
+    break;
+
+    case ASSET_SOUND:
     {
-        arq = fopen("rankscore.bin", "w+b");
+        Sound *sound = (Sound *)request->target;
+
+        if (decoded->wave.data != NULL)
+        {
+            *sound = LoadSoundFromWave(decoded->wave);
+            SetSoundVolume(*sound, request->volume);
+            FreeDecodedAsset(decoded);
+        }
+    }
+    break;
 
-        fwrite(&player1, sizeof(Playerscore), 1, arq);
+    case ASSET_SFX:
+    {
+        int *sfx = (int *)request->target;
 
-        for (int i = 0; i < 9; i++)
+        if (decoded->wave.data != NULL)
         {
-            fwrite(&reg, sizeof(Playerscore), 1, arq);
+            *sfx = LoadSfx(decoded->wave, request->voices, request->volume);
+            FreeDecodedAsset(decoded);
         }
-        fclose(arq);
     }
-    else
+    break;
+
+    case ASSET_MUSIC:
     {
-        for (int i = 0; i < 10; i++)
+        Music *music = (Music *)request->target;
+
+        if (decoded->data != NULL)
         {
-            fread(&reg, sizeof(Playerscore), 1, arq);
-            if (player1.fscore > reg.fscore)
-            {
-                temp = reg;
+            *music = LoadMusicStreamFromMemory(GetFileExtension(request->fileName), decoded->data, decoded->dataSize);
+            SetSongVolume(music, request->volume);
+        }
+    }
+    break;
 
-                fseek(arq, -sizeof(Playerscore), 1);
+    default:
+        break;
+    }
+}
 
-                fwrite(&player1, sizeof(Playerscore), 1, arq);
+#if defined(ASSET_LOADER_THREADED)
+static void *AssetWorker(void *arg)
+{
+    for (int i = 0; i < ASSET_COUNT; i++)
+    {
+        if (__atomic_load_n(&assetLoaderQuit, __ATOMIC_RELAXED))
+            break;
+
+        DecodeAsset(i);
+        __atomic_store_n(&assetsDecoded, i + 1, __ATOMIC_RELEASE);
+    }
 
-                player1 = temp;
+    return NULL;
+}
+#endif
+
+void StartAssetLoader(void)
+{
+    // Decided before the worker starts, it picks the atlas page or the loose sprites
+    atlasAvailable = LoadAtlasRects();
+
+#if defined(ASSET_LOADER_THREADED)
+    if (pthread_create(&assetThread, NULL, AssetWorker, NULL) == 0)
+        assetThreadRunning = true;
+    else
+    {
+        // Without a worker, everything is decoded up front like before
+        TraceLog(LOG_WARNING, "ASSETS: Failed to start the loader thread, loading synchronously");
+
+        for (int i = 0; i < ASSET_COUNT; i++)
+            DecodeAsset(i);
+
+        assetsDecoded = ASSET_COUNT;
+    }
+#endif
+}
+
+// Called once per rendered frame
+void UpdateAssetLoader(void)
+{
+#if !defined(ASSET_LOADER_THREADED)
+    if (assetsDecoded < ASSET_COUNT)
+    {
+        DecodeAsset(assetsDecoded);
+        assetsDecoded++;
+    }
+#endif
+
+    int decoded = __atomic_load_n(&assetsDecoded, __ATOMIC_ACQUIRE);
+
+    for (int i = 0; i < MAX_ASSET_UPLOADS && assetsUploaded < decoded; i++)
+    {
+        UploadAsset(assetsUploaded);
+        assetsUploaded++;
+    }
+
+#if defined(ASSET_LOADER_THREADED)
+    if (assetThreadRunning && decoded == ASSET_COUNT)
+    {
+        pthread_join(assetThread, NULL);
+        assetThreadRunning = false;
+    }
+#endif
+}
+
+// Stops the worker and frees whatever it decoded, including the memory the music
+// streams play from, so it must run after they are unloaded
+void StopAssetLoader(void)
+{
+#if defined(ASSET_LOADER_THREADED)
+    if (assetThreadRunning)
+    {
+        __atomic_store_n(&assetLoaderQuit, true, __ATOMIC_RELAXED);
+        pthread_join(assetThread, NULL);
+        assetThreadRunning = false;
+    }
+#endif
+
+    for (int i = 0; i < assetsDecoded; i++)
+        FreeDecodedAsset(&decodedAssets[i]);
+}
+
+// Groups load in order, so a group is ready once the next upload belongs to a later one
+bool AssetGroupReady(AssetGroup group)
+{
+    return (assetsUploaded == ASSET_COUNT) || (assetRequests[assetsUploaded].group > group);
+}
+
+// Decoding and uploading count as half of each asset
+float AssetLoaderProgress(void)
+{
+    int decoded = __atomic_load_n(&assetsDecoded, __ATOMIC_ACQUIRE);
+
+    return (float)(decoded + assetsUploaded) / (2 * ASSET_COUNT);
+}
+
+//------------------------------------------------------------------------------------
+// Loading screen
+//------------------------------------------------------------------------------------
+static AssetGroup ScreenAssetGroup(GameScreen screen)
+{
+    switch (screen)
+    {
+    case NARRATIVE:
+        return ASSET_GROUP_NARRATIVE;
+
+    case GAMEPLAY:
+    case ENDING:
+        return ASSET_GROUP_GAMEPLAY;
+
+    default:
+        return ASSET_GROUP_TITLE;
+    }
+}
+
+// Go to a screen, through the loading screen if its assets are not uploaded yet
+void ChangeScreen(GameScreen screen)
+{
+    if (AssetGroupReady(ScreenAssetGroup(screen)))
+        currentScreen = screen;
+    else
+    {
+        pendingScreen = screen;
+        currentScreen = LOADING;
+    }
+}
+
+void UpdateLoading(void)
+{
+    // Whatever was playing before carries on, the music player keeps it fed
+    if (AssetGroupReady(ScreenAssetGroup(pendingScreen)))
+        currentScreen = pendingScreen;
+}
+
+void DrawLoading(void)
+{
+    // loading.png is optional, the logo background stands in for it
+    if (loading.id != 0)
+        DrawTexturePro(loading, (Rectangle){0, 0, loading.width, loading.height}, (Rectangle){0, 0, screenWidth, screenHeight}, (Vector2){0, 0}, 0, WHITE);
+    else
+        DrawTexturePro(backgroundLogo, (Rectangle){0, 0, 890, 470}, (Rectangle){0, 0, screenWidth, screenHeight}, (Vector2){0, 0}, 0, WHITE);
+
+    float progress = AssetLoaderProgress();
+    int barWidth = screenWidth / 2;
+    int barX = screenWidth / 2 - barWidth / 2;
+    int barY = screenHeight - 120;
+
+    DrawRectangle(barX, barY, barWidth, 24, CLITERAL(Color){0, 0, 0, 160});
+    DrawRectangle(barX, barY, (int)(barWidth * progress), 24, RAYWHITE);
+    DrawRectangleLines(barX, barY, barWidth, 24, RAYWHITE);
+    DrawText(TextFormat("LOADING %i%%", (int)(progress * 100)), barX, barY - 40, 30, RAYWHITE);
+}
+
+//------------------------------------------------------------------------------------
+// Waves
+//------------------------------------------------------------------------------------
+// Compiled once at startup and kept across restarts. A missing or broken file leaves
+// the built-in waves in place.
+static void LoadWaves(void)
+{
+    char *text = LoadFileText(WAVES_FILE);
+    char error[128] = {0};
+
+    if (text == NULL)
+        return;
+
+    if (CompileWaves(text, &waveTable, error, sizeof(error)))
+        game.waveTable = &waveTable;
+    else
+        TraceLog(LOG_WARNING, "WAVES: [%s] %s, using the built-in waves", WAVES_FILE, error);
+
+    UnloadFileText(text);
+}
+
+//------------------------------------------------------------------------------------
+// Sprite atlas
+//------------------------------------------------------------------------------------
+// Reads the rect table written by tools/atlas_packer.c. Any missing or unknown
+// sprite means a stale atlas, and the loose files are used instead.
+bool LoadAtlasRects(void)
+{
+    if (!FileExists(ATLAS_IMAGE_FILE))
+        return false;
+
+    char *text = LoadFileText(ATLAS_RECTS_FILE);
+
+    if (text == NULL)
+        return false;
+
+    bool found[ATLAS_SPRITE_COUNT] = {0};
+    int foundCount = 0;
+    char *line = text;
+
+    while (*line != '\0')
+    {
+        char id[64] = {0};
+        int x, y, width, height;
+
+        if (sscanf(line, "%63s %i %i %i %i", id, &x, &y, &width, &height) == 5)
+        {
+            for (int i = 0; i < ATLAS_SPRITE_COUNT; i++)
+            {
+                if (!found[i] && strcmp(spriteNames[i], id) == 0)
+                {
+                    spriteRects[i] = (Rectangle){x, y, width, height};
+                    found[i] = true;
+                    foundCount++;
+                }
             }
         }
-        fclose(arq);
+
+        char *next = strchr(line, '\n');
+        line = (next != NULL) ? next + 1 : line + strlen(line);
     }
-    for (int i = 0; i < 11; i++)
+
+    UnloadFileText(text);
+
+    if (foundCount != ATLAS_SPRITE_COUNT)
     {
-        printf("%s", player1.name);
+        TraceLog(LOG_WARNING, "ATLAS: [%s] is out of date, run make atlas", ATLAS_RECTS_FILE);
+        return false;
     }
+
+    return true;
+}
+
+// Queue a gameplay sprite, src is relative to the sprite's own sheet as if it had been loaded on its own
+static void DrawSprite(AtlasSprite sprite, Rectangle src, Rectangle dest, Vector2 origin, SpriteLayer layer)
+{
+    if (atlasAvailable)
+    {
+        src.x += spriteRects[sprite].x;
+        src.y += spriteRects[sprite].y;
+        QueueSprite(atlasTexture, src, dest, origin, layer, WHITE);
+    }
+    else
+        QueueSprite(spriteTextures[sprite], src, dest, origin, layer, WHITE);
+}
+
+//------------------------------------------------------------------------------------
+// Render interpolation
+//------------------------------------------------------------------------------------
+// The core keeps every position from the start of the tick; the draw code blends
+// from there towards the current one by the interpolation factor
+static inline Rectangle InterpolateRec(Rectangle rec, float prevX, float prevY)
+{
+    rec.x = prevX + (rec.x - prevX) * interpolation;
+    rec.y = prevY + (rec.y - prevY) * interpolation;
+
+    return rec;
+}
+
+// Whether a sprite drawn at dest (DrawTexturePro() conventions, no rotation) touches the view
+static inline bool SpriteVisible(Rectangle dest, Vector2 origin, Rectangle view)
+{
+    float left = dest.x - origin.x;
+    float top = dest.y - origin.y;
+
+    return (left < view.x + view.width) && (left + dest.width > view.x) &&
+           (top < view.y + view.height) && (top + dest.height > view.y);
+}
+
+void scorerank(void)
+{
+    player1.fscore = game.score;
+
+    if (!SubmitScore(player1.name, player1.fscore))
+        TraceLog(LOG_WARNING, "RANK: Score queue is full, %i wasn't saved", player1.fscore);
+
+    UpdateScoreBoard();
+}
+
+// Takes the board the score client last published, only reformats when it changed
+static void UpdateScoreBoard(void)
+{
+    UpdateScoreClient();
+
+    if (!GetScoreBoard(&scoreBoard))
+        return;
+
+    for (int i = 0; i < scoreBoard.topCount; i++)
+        snprintf(rankScoreText[i], sizeof(rankScoreText[i]), "%04i", scoreBoard.top[i].score);
+
+    if (scoreBoard.pending > 0)
+        snprintf(rankPlayerText, sizeof(rankPlayerText), scoreBoard.offline ? "SCORE SAVED LATER, BOARD OFFLINE" : "SAVING SCORE...");
+    else if (scoreBoard.offline)
+        snprintf(rankPlayerText, sizeof(rankPlayerText), "LEADERBOARD OFFLINE");
+    else if (scoreBoard.position >= 0)
+        snprintf(rankPlayerText, sizeof(rankPlayerText), "YOUR RANK: %i OF %i", scoreBoard.position + 1, scoreBoard.total);
+    else
+        rankPlayerText[0] = '\0';
 }
 
 void Input_text(void)
@@ -2041,23 +1792,23 @@ void Input_text(void)
         SetMouseCursor(MOUSE_CURSOR_IBEAM);
 
         // Get char pressed (unicode character) on the queue
-        int key = GetCharPressed();
+        int key = LatchedCharPressed();
 
         // Check if more characters have been pressed on the same frame
         while (key > 0)
         {
             // NOTE: Only allow keys in range [32..125]
-            if ((key >= 32) && (key <= 125) && (letterCount < 10))
+            if ((key >= 32) && (key <= 125) && (letterCount < RANK_NAME_SIZE - 1))
             {
                 player1.name[letterCount] = (char)key;
                 player1.name[letterCount + 1] = '\0'; // Add null terminator at the end of the string.
                 letterCount++;
             }
 
-            key = GetCharPressed(); // Check next character in the queue
+            key = LatchedCharPressed(); // Check next character in the queue
         }
 
-        if (IsKeyPressed(KEY_BACKSPACE))
+        if (LatchedKeyPressed(KEY_BACKSPACE))
         {
             letterCount--;
             if (letterCount < 0)
@@ -2072,43 +1823,34 @@ void Input_text(void)
         framesCounter++;
     else
         framesCounter = 0;
+
+    if (letterCount != letterCountShown)
+    {
+        letterCountShown = letterCount;
+        snprintf(letterCountText, sizeof(letterCountText), "INPUT CHARS: %i/%i", letterCount, RANK_NAME_SIZE - 1);
+    }
 }
 
 void UpdateEnd(void)
 {
-    bgDest.width = GetScreenWidth();
-    bgDest.height = GetScreenHeight();
+    bgDest.width = screenWidth;
+    bgDest.height = screenHeight;
     bgSrc.width = 890;
     bgSrc.height = 470;
 
     // Background music for logo screen
-    UpdateMusicStream(backgroundMenu.song);
-    PlayMusicStream(backgroundMenu.song);
+    PlaySong(&backgroundMenu.song);
 
-    if (IsKeyPressed(KEY_ENTER))
+    if (LatchedKeyPressed(KEY_ENTER))
         endcount = true;
 
     Input_text();
 
-    if (endcount)
+    // Submitted once per game, the ranking is drawn from memory afterwards
+    if (endcount && game.gameOver)
     {
-        if(gameOver)
-        {
-            scorerank();
-            gameOver = false;
-        }
-
-        if (KEY_ENTER)
-        {
-            FILE *arq;
-            arq = fopen("rankscore.bin", "rb");
-
-            for (int i = 0; i < 10; i++)
-            {
-                fread(&rankplayer[i], sizeof(Playerscore), 1, arq);
-            }
-            fclose(arq);
-        }
+        scorerank();
+        game.gameOver = false;
     }
 }
 
@@ -2120,34 +1862,24 @@ void DrawEnd(void)
 
     if (endcount)
     {
-        DrawText("RANK", GetScreenWidth() / 2 - MeasureText("RANK", 20) / 2, 40, 20, GRAY);
-        DrawText(TextFormat("%s", rankplayer[0].name), GetScreenWidth() / 2 - MeasureText(TextFormat("%s", rankplayer[0].name), 20) / 2, 80, 20, GRAY);
-        DrawText(TextFormat("%04i", rankplayer[0].fscore), 1000, 80, 20, GRAY);
-        DrawText(TextFormat("%s", rankplayer[1].name),  GetScreenWidth() / 2 - MeasureText(TextFormat("%s", rankplayer[1].name), 20) / 2, 160, 20, GRAY);
-        DrawText(TextFormat("%04i", rankplayer[1].fscore), 1000, 160, 20, GRAY);
-        DrawText(TextFormat("%s", rankplayer[2].name),  GetScreenWidth() / 2 - MeasureText(TextFormat("%s", rankplayer[2].name), 20) / 2, 240, 20, GRAY);
-        DrawText(TextFormat("%04i", rankplayer[2].fscore), 1000, 240, 20, GRAY);
-        DrawText(TextFormat("%s", rankplayer[3].name),  GetScreenWidth() / 2 - MeasureText(TextFormat("%s", rankplayer[3].name), 20) / 2, 320, 20, GRAY);
-        DrawText(TextFormat("%04i", rankplayer[3].fscore), 1000, 320, 20, GRAY);
-        DrawText(TextFormat("%s", rankplayer[4].name),  GetScreenWidth() / 2 - MeasureText(TextFormat("%s", rankplayer[4].name), 20) / 2, 400, 20, GRAY);
-        DrawText(TextFormat("%04i", rankplayer[4].fscore), 1000, 400, 20, GRAY);
-        DrawText(TextFormat("%s", rankplayer[5].name),  GetScreenWidth() / 2 - MeasureText(TextFormat("%s", rankplayer[5].name), 20) / 2, 480, 20, GRAY);
-        DrawText(TextFormat("%04i", rankplayer[5].fscore), 1000, 480, 20, GRAY);
-        DrawText(TextFormat("%s", rankplayer[6].name),  GetScreenWidth() / 2 - MeasureText(TextFormat("%s", rankplayer[6].name), 20) / 2, 560, 20, GRAY);
-        DrawText(TextFormat("%04i", rankplayer[6].fscore), 1000, 560, 20, GRAY);
-        DrawText(TextFormat("%s", rankplayer[7].name),  GetScreenWidth() / 2 - MeasureText(TextFormat("%s", rankplayer[7].name), 20) / 2, 640, 20, GRAY);
-        DrawText(TextFormat("%04i", rankplayer[7].fscore), 1000, 640, 20, GRAY);
-        DrawText(TextFormat("%s", rankplayer[8].name),  GetScreenWidth() / 2 - MeasureText(TextFormat("%s", rankplayer[8].name), 20) / 2, 720, 20, GRAY);
-        DrawText(TextFormat("%04i", rankplayer[8].fscore), 1000, 720, 20, GRAY);
-        DrawText(TextFormat("%s", rankplayer[9].name),  GetScreenWidth() / 2 - MeasureText(TextFormat("%s", rankplayer[9].name), 20) / 2, 800, 20, GRAY);
-        DrawText(TextFormat("%04i", rankplayer[9].fscore), 1000, 800, 20, GRAY);
-        DrawText("PRESS [SPACE] TO PLAY AGAIN", GetScreenWidth() / 2 - MeasureText("PRESS [SPACE] TO PLAY AGAIN", 20) / 2, 850, 20, GRAY);
+        DrawCachedText("RANK", screenWidth / 2 - MeasureCachedText("RANK", 20) / 2, 40, 20, GRAY);
+
+        for (int i = 0; i < scoreBoard.topCount; i++)
+        {
+            DrawCachedText(scoreBoard.top[i].name, screenWidth / 2 - MeasureCachedText(scoreBoard.top[i].name, 20) / 2, 80 + 80 * i, 20, GRAY);
+            DrawCachedText(rankScoreText[i], 1000, 80 + 80 * i, 20, GRAY);
+        }
+
+        if (rankPlayerText[0] != '\0')
+            DrawCachedText(rankPlayerText, 1000, 40, 20, MAROON);
+
+        DrawCachedText("PRESS [SPACE] TO PLAY AGAIN", screenWidth / 2 - MeasureCachedText("PRESS [SPACE] TO PLAY AGAIN", 20) / 2, 850, 20, GRAY);
         
     }
 
     if (endcount == false)
     {
-        DrawText("PLACE MOUSE OVER INPUT BOX!", GetScreenWidth() / 2 - MeasureText("PLACE MOUSE OVER INPUT BOX!", 20) / 2, 140, 20, GRAY);
+        DrawCachedText("PLACE MOUSE OVER INPUT BOX!", screenWidth / 2 - MeasureCachedText("PLACE MOUSE OVER INPUT BOX!", 20) / 2, 140, 20, GRAY);
 
         DrawRectangleRec(textBox, LIGHTGRAY);
         if (mouseOnText)
@@ -2155,20 +1887,20 @@ void DrawEnd(void)
         else
             DrawRectangleLines((int)textBox.x, (int)textBox.y, (int)textBox.width, (int)textBox.height, DARKGRAY);
 
-        DrawText(player1.name, (int)textBox.x + 5, (int)textBox.y + 8, 40, MAROON);
+        DrawCachedText(player1.name, (int)textBox.x + 5, (int)textBox.y + 8, 40, MAROON);
 
-        DrawText(TextFormat("INPUT CHARS: %i/%i", letterCount, 10), GetScreenWidth() / 2 - MeasureText("INPUT CHARS: %i/%i", 20) / 2, 250, 20, DARKGRAY);
-        DrawText("PRESS [ENTER] TO CONFIRM YOUR NICKNAME", GetScreenWidth() / 2 - MeasureText("PRESS [ENTER] TO CONFIRM YOUR NICKNAME", 20) / 2, 350, 20, GRAY);
+        DrawCachedText(letterCountText, screenWidth / 2 - MeasureCachedText(letterCountText, 20) / 2, 250, 20, DARKGRAY);
+        DrawCachedText("PRESS [ENTER] TO CONFIRM YOUR NICKNAME", screenWidth / 2 - MeasureCachedText("PRESS [ENTER] TO CONFIRM YOUR NICKNAME", 20) / 2, 350, 20, GRAY);
 
         if (mouseOnText)
         {
-            if (letterCount < 10)
+            if (letterCount < RANK_NAME_SIZE - 1)
             {
                 // Draw blinking underscore char
-                DrawText("_", (int)textBox.x + 8 + MeasureText(player1.name, 40), (int)textBox.y + 12, 40, MAROON);
+                DrawCachedText("_", (int)textBox.x + 8 + MeasureCachedText(player1.name, 40), (int)textBox.y + 12, 40, MAROON);
             }
             else
-                DrawText("Press BACKSPACE to delete chars...", 230, 300, 20, GRAY);
+                DrawCachedText("Press BACKSPACE to delete chars...", 230, 300, 20, GRAY);
         }
     }
 }
\ No newline at end of file
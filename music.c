@@ -0,0 +1,225 @@
+/*******************************************************************************************
+*
+*   Music player - keeps the music streams fed from a worker thread, so a long frame on
+*   the main thread doesn't starve them. Commands go through a single producer, single
+*   consumer ring: the main thread only advances its head, the worker only its tail.
+*
+********************************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "music.h"
+
+#if !defined(PLATFORM_WEB)
+#define MUSIC_PLAYER_THREADED // No threads on the web, the streams are refilled between frames
+#include <pthread.h>
+#if defined(_WIN32)
+// windows.h clashes with raylib.h, declare the one call needed
+__declspec(dllimport) void __stdcall Sleep(unsigned long milliseconds);
+#else
+#include <time.h>
+#endif
+#endif
+
+//----------------------------------------------------------------------------------
+// Some Defines
+//----------------------------------------------------------------------------------
+#define SONG_COMMAND_CAPACITY 64 // Must be a power of two
+#define MUSIC_UPDATE_INTERVAL 5 // Milliseconds between refills, a stream sub-buffer lasts far longer
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum
+{
+    SONG_PLAY = 0,
+    SONG_STOP,
+    SONG_VOLUME
+} SongCommandType;
+
+typedef struct SongCommand
+{
+    SongCommandType type;
+    Music *music; // NULL with SONG_PLAY pauses the current song
+    float volume;
+} SongCommand;
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+static SongCommand commands[SONG_COMMAND_CAPACITY] = {0};
+static unsigned int commandHead = 0; // Next slot the main thread writes, published with release stores
+static unsigned int commandTail = 0; // Next slot the worker reads, published with release stores
+
+static Music *requestedSong = NULL; // Main thread's view, so repeated PlaySong() calls aren't queued
+static Music *currentSong = NULL; // Worker's view, the stream it keeps refilling
+
+#if defined(MUSIC_PLAYER_THREADED)
+static pthread_t musicThread;
+static bool musicThreadRunning = false;
+static bool musicPlayerQuit = false;
+#endif
+
+//------------------------------------------------------------------------------------
+// Module Functions Definition
+//------------------------------------------------------------------------------------
+#if defined(MUSIC_PLAYER_THREADED)
+static void SleepMilliseconds(int milliseconds)
+{
+#if defined(_WIN32)
+    Sleep(milliseconds);
+#else
+    struct timespec duration = {0, milliseconds * 1000000L};
+    nanosleep(&duration, NULL);
+#endif
+}
+#endif
+
+// Consumer side, only ever runs on one thread at a time
+static void RunSongCommands(void)
+{
+    unsigned int tail = __atomic_load_n(&commandTail, __ATOMIC_RELAXED);
+    unsigned int head = __atomic_load_n(&commandHead, __ATOMIC_ACQUIRE);
+
+    while (tail != head)
+    {
+        const SongCommand *command = &commands[tail & (SONG_COMMAND_CAPACITY - 1)];
+
+        switch (command->type)
+        {
+        case SONG_PLAY:
+            if (currentSong != NULL && currentSong != command->music)
+                PauseMusicStream(*currentSong);
+
+            currentSong = command->music;
+
+            if (currentSong != NULL)
+            {
+                // A paused stream carries on where it was, a stopped one starts over
+                ResumeMusicStream(*currentSong);
+
+                if (!IsMusicStreamPlaying(*currentSong))
+                    PlayMusicStream(*currentSong);
+            }
+            break;
+
+        case SONG_STOP:
+            StopMusicStream(*command->music);
+
+            if (currentSong == command->music)
+                currentSong = NULL;
+            break;
+
+        case SONG_VOLUME:
+            SetMusicVolume(*command->music, command->volume);
+            break;
+
+        default:
+            break;
+        }
+
+        tail++;
+        __atomic_store_n(&commandTail, tail, __ATOMIC_RELEASE);
+    }
+
+    if (currentSong != NULL)
+        UpdateMusicStream(*currentSong);
+}
+
+// Producer side, main thread only
+static void PushSongCommand(SongCommand command)
+{
+    unsigned int head = __atomic_load_n(&commandHead, __ATOMIC_RELAXED);
+
+    while (head - __atomic_load_n(&commandTail, __ATOMIC_ACQUIRE) == SONG_COMMAND_CAPACITY)
+    {
+        // Full, the worker drains it within a refill interval
+#if defined(MUSIC_PLAYER_THREADED)
+        if (musicThreadRunning)
+            SleepMilliseconds(1);
+        else
+#endif
+            RunSongCommands();
+    }
+
+    commands[head & (SONG_COMMAND_CAPACITY - 1)] = command;
+    __atomic_store_n(&commandHead, head + 1, __ATOMIC_RELEASE);
+}
+
+#if defined(MUSIC_PLAYER_THREADED)
+static void *MusicWorker(void *arg)
+{
+    while (!__atomic_load_n(&musicPlayerQuit, __ATOMIC_RELAXED))
+    {
+        RunSongCommands();
+        SleepMilliseconds(MUSIC_UPDATE_INTERVAL);
+    }
+
+    return NULL;
+}
+#endif
+
+void StartMusicPlayer(void)
+{
+#if defined(MUSIC_PLAYER_THREADED)
+    musicPlayerQuit = false;
+
+    if (pthread_create(&musicThread, NULL, MusicWorker, NULL) == 0)
+        musicThreadRunning = true;
+    else
+        TraceLog(LOG_WARNING, "MUSIC: Failed to start the music thread, refilling streams every frame");
+#endif
+}
+
+void StopMusicPlayer(void)
+{
+#if defined(MUSIC_PLAYER_THREADED)
+    if (musicThreadRunning)
+    {
+        __atomic_store_n(&musicPlayerQuit, true, __ATOMIC_RELAXED);
+        pthread_join(musicThread, NULL);
+        musicThreadRunning = false;
+    }
+#endif
+
+    // Whatever is still queued no longer matters, the streams are about to go away
+    __atomic_store_n(&commandTail, __atomic_load_n(&commandHead, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    requestedSong = NULL;
+    currentSong = NULL;
+}
+
+void UpdateMusicPlayer(void)
+{
+#if defined(MUSIC_PLAYER_THREADED)
+    if (musicThreadRunning)
+        return;
+#endif
+
+    RunSongCommands();
+}
+
+void PlaySong(Music *music)
+{
+    if (music == requestedSong)
+        return;
+
+    requestedSong = music;
+    PushSongCommand((SongCommand){SONG_PLAY, music, 0.0f});
+}
+
+void StopSong(Music *music)
+{
+    if (music == NULL)
+        return;
+
+    if (music == requestedSong)
+        requestedSong = NULL;
+
+    PushSongCommand((SongCommand){SONG_STOP, music, 0.0f});
+}
+
+void SetSongVolume(Music *music, float volume)
+{
+    if (music != NULL)
+        PushSongCommand((SongCommand){SONG_VOLUME, music, volume});
+}
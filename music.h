@@ -0,0 +1,22 @@
+#ifndef MUSIC_H
+#define MUSIC_H
+
+#include "raylib.h"
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration
+//------------------------------------------------------------------------------------
+// Music streams are decoded and refilled on a worker thread, the main thread only queues
+// commands. Once a Music has been passed to one of these, only the worker touches it
+// until StopMusicPlayer() returns.
+void StartMusicPlayer(void);
+void StopMusicPlayer(void); // Joins the worker, call it before unloading the streams
+void UpdateMusicPlayer(void); // Once per frame, refills the streams itself when there is no worker
+
+// One song is audible at a time. Playing another one pauses the previous one where it
+// was, NULL pauses the current one. Playing the current song again does nothing.
+void PlaySong(Music *music);
+void StopSong(Music *music); // Rewinds it, PlaySong() starts it over
+void SetSongVolume(Music *music, float volume);
+
+#endif // MUSIC_H
@@ -0,0 +1,203 @@
+/*******************************************************************************************
+*
+*   Asset pack - maps the archive written by tools/asset_packer.c and looks assets up by
+*   path through its hash index, so startup reads decoded data in place instead of
+*   opening and decoding every loose file
+*
+********************************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+#include "pack.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h> // Not mixed with raylib.h, this file doesn't need it
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+static const unsigned char *packData = NULL;
+static size_t packSize = 0;
+static const unsigned int *packBuckets = NULL;
+static const PackEntry *packEntries = NULL;
+static unsigned int packBucketCount = 0;
+static unsigned int packEntryCount = 0;
+#if defined(_WIN32)
+static HANDLE packFile = INVALID_HANDLE_VALUE;
+static HANDLE packMapping = NULL;
+#endif
+
+//------------------------------------------------------------------------------------
+// Module Functions Definition
+//------------------------------------------------------------------------------------
+unsigned int HashPackName(const char *fileName)
+{
+    unsigned int hash = 2166136261u; // FNV-1a
+
+    for (const unsigned char *c = (const unsigned char *)fileName; *c != '\0'; c++)
+        hash = (hash ^ *c) * 16777619u;
+
+    return hash;
+}
+
+static bool MapPackFile(const char *fileName)
+{
+#if defined(_WIN32)
+    packFile = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (packFile == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+
+    if (GetFileSizeEx(packFile, &size) && size.QuadPart > 0)
+        packMapping = CreateFileMappingA(packFile, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if (packMapping != NULL)
+        packData = (const unsigned char *)MapViewOfFile(packMapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (packData == NULL)
+        return false;
+
+    packSize = (size_t)size.QuadPart;
+#else
+    int file = open(fileName, O_RDONLY);
+
+    if (file < 0)
+        return false;
+
+    struct stat info;
+
+    if (fstat(file, &info) == 0 && info.st_size > 0)
+    {
+        void *mapped = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+        if (mapped != MAP_FAILED)
+        {
+            packData = (const unsigned char *)mapped;
+            packSize = (size_t)info.st_size;
+        }
+    }
+
+    close(file); // The mapping keeps its own reference
+
+    if (packData == NULL)
+        return false;
+#endif
+
+    return true;
+}
+
+bool OpenAssetPack(const char *fileName)
+{
+    CloseAssetPack();
+
+    if (!MapPackFile(fileName))
+    {
+        CloseAssetPack();
+        return false;
+    }
+
+    // Everything the lookups touch has to be inside the file, a truncated or stale pack
+    // is dropped as a whole and the game reads the loose files instead
+    const PackHeader *header = (const PackHeader *)packData;
+    bool valid = (packSize >= sizeof(PackHeader)) && (header->magic == PACK_MAGIC) && (header->version == PACK_VERSION) &&
+                 (header->bucketCount > 0) && ((header->bucketCount & (header->bucketCount - 1)) == 0) &&
+                 (header->entryCount < header->bucketCount);
+
+    size_t tableEnd = sizeof(PackHeader);
+
+    if (valid)
+    {
+        tableEnd += (size_t)header->bucketCount * sizeof(unsigned int) + (size_t)header->entryCount * sizeof(PackEntry);
+        valid = (tableEnd <= packSize);
+    }
+
+    if (valid)
+    {
+        packBucketCount = header->bucketCount;
+        packEntryCount = header->entryCount;
+        packBuckets = (const unsigned int *)(packData + sizeof(PackHeader));
+        packEntries = (const PackEntry *)(packBuckets + packBucketCount);
+
+        for (unsigned int i = 0; i < packEntryCount && valid; i++)
+        {
+            const PackEntry *entry = &packEntries[i];
+
+            valid = (entry->nameOffset < packSize) && (memchr(packData + entry->nameOffset, '\0', packSize - entry->nameOffset) != NULL) &&
+                    (entry->dataOffset <= packSize) && (entry->dataSize <= packSize - entry->dataOffset);
+        }
+
+        for (unsigned int i = 0; i < packBucketCount && valid; i++)
+            valid = (packBuckets[i] <= packEntryCount);
+    }
+
+    if (!valid)
+    {
+        CloseAssetPack();
+        return false;
+    }
+
+    return true;
+}
+
+void CloseAssetPack(void)
+{
+#if defined(_WIN32)
+    if (packData != NULL)
+        UnmapViewOfFile(packData);
+
+    if (packMapping != NULL)
+        CloseHandle(packMapping);
+
+    if (packFile != INVALID_HANDLE_VALUE)
+        CloseHandle(packFile);
+
+    packMapping = NULL;
+    packFile = INVALID_HANDLE_VALUE;
+#else
+    if (packData != NULL)
+        munmap((void *)packData, packSize);
+#endif
+
+    packData = NULL;
+    packSize = 0;
+    packBuckets = NULL;
+    packEntries = NULL;
+    packBucketCount = 0;
+    packEntryCount = 0;
+}
+
+const PackEntry *FindPackEntry(const char *fileName)
+{
+    if (packData == NULL)
+        return NULL;
+
+    unsigned int hash = HashPackName(fileName);
+
+    // The bucket count is larger than the entry count, so an empty bucket ends the probe
+    for (unsigned int slot = hash & (packBucketCount - 1);; slot = (slot + 1) & (packBucketCount - 1))
+    {
+        unsigned int index = packBuckets[slot];
+
+        if (index == 0)
+            return NULL;
+
+        const PackEntry *entry = &packEntries[index - 1];
+
+        if (entry->hash == hash && strcmp((const char *)packData + entry->nameOffset, fileName) == 0)
+            return entry;
+    }
+}
+
+const void *GetPackEntryData(const PackEntry *entry)
+{
+    return packData + entry->dataOffset;
+}
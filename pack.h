@@ -0,0 +1,59 @@
+#ifndef PACK_H
+#define PACK_H
+
+#include <stdbool.h>
+
+//----------------------------------------------------------------------------------
+// Some Defines
+//----------------------------------------------------------------------------------
+#define PACK_MAGIC 0x4b50444e // "NDPK" read as a little-endian integer
+#define PACK_VERSION 2 // 2: large textures stored block compressed
+#define PACK_ALIGNMENT 16 // Entry data offsets are multiples of it
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// Layout: PackHeader, bucketCount bucket slots (entry index + 1, 0 when empty, probed
+// linearly from hash & (bucketCount - 1)), entryCount PackEntry, names, then the data.
+// Everything is little-endian and addressed from the start of the file.
+typedef enum
+{
+    PACK_FILE = 0, // File as it is on disk (music streams decode it while playing)
+    PACK_IMAGE,    // Decoded RGBA pixels or DXT blocks, ready for LoadTextureFromImage()
+    PACK_WAVE      // Decoded samples, ready for LoadSoundFromWave()
+} PackEntryType;
+
+typedef struct PackHeader
+{
+    unsigned int magic;
+    unsigned int version;
+    unsigned int entryCount;
+    unsigned int bucketCount; // Power of two
+} PackHeader;
+
+typedef struct PackEntry
+{
+    unsigned int hash; // HashPackName() of the asset path
+    unsigned int type;
+    unsigned int nameOffset; // NUL terminated asset path, as the game asks for it
+    unsigned int dataOffset;
+    unsigned int dataSize;
+    int width;   // Images: pixels, waves: frame count
+    int height;  // Images: pixels, waves: sample rate
+    int format;  // Images: raylib PixelFormat, waves: sample size in bits
+    int mipmaps; // Images: mipmap count, waves: channels
+} PackEntry;
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration
+//------------------------------------------------------------------------------------
+// The pack stays mapped until CloseAssetPack(), entry data can be used in place (and
+// must not be freed) until then. Lookups are safe from any thread.
+bool OpenAssetPack(const char *fileName);
+void CloseAssetPack(void);
+const PackEntry *FindPackEntry(const char *fileName); // NULL without a pack or for a missing file
+const void *GetPackEntryData(const PackEntry *entry);
+
+unsigned int HashPackName(const char *fileName);
+
+#endif // PACK_H
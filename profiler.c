@@ -0,0 +1,139 @@
+/*******************************************************************************************
+*
+*   Frame profiler - rolling per-zone timings and counters, drawn as an overlay
+*
+*   Compiled only when ENABLE_PROFILER is defined (debug builds)
+*
+********************************************************************************************/
+
+#include "profiler.h"
+
+#if defined(ENABLE_PROFILER)
+
+#include <string.h>
+#include "raylib.h"
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+static const char *zoneNames[PROFILE_ZONE_COUNT] = {
+    "wave", "player", "approach", "separation", "chase", "animation", "shoots", "collision", "release",
+    "update", "draw"
+};
+
+static const char *counterNames[PROFILE_COUNTER_COUNT] = {
+    "batches", "vertices", "textures", "enemies", "shoots", "scale %", "voices"
+};
+
+static bool profilerVisible = false;
+static double zoneStart[PROFILE_ZONE_COUNT] = {0};
+static double zoneFrame[PROFILE_ZONE_COUNT] = {0}; // Seconds accumulated this frame
+static float zoneHistory[PROFILE_ZONE_COUNT][PROFILE_HISTORY] = {0}; // Milliseconds
+static int counterFrame[PROFILE_COUNTER_COUNT] = {0};
+static int counterShown[PROFILE_COUNTER_COUNT] = {0}; // Last finished frame
+static int historyIndex = 0;
+static int historyCount = 0;
+
+//------------------------------------------------------------------------------------
+// Module Functions Definition
+//------------------------------------------------------------------------------------
+// A zone may be entered several times per frame (one per tick, one per shuriken...),
+// its time adds up until ProfileFrame()
+void ProfileBegin(int zone)
+{
+    zoneStart[zone] = GetTime();
+}
+
+void ProfileEnd(int zone)
+{
+    zoneFrame[zone] += GetTime() - zoneStart[zone];
+}
+
+void ProfileCount(ProfileCounter counter, int amount)
+{
+    counterFrame[counter] += amount;
+}
+
+void ProfileSet(ProfileCounter counter, int value)
+{
+    counterFrame[counter] = value;
+}
+
+void ProfileGameStage(GameStage stage, bool begin, void *userData)
+{
+    if (begin)
+        ProfileBegin(stage);
+    else
+        ProfileEnd(stage);
+}
+
+void ProfileFrame(void)
+{
+    for (int i = 0; i < PROFILE_ZONE_COUNT; i++)
+        zoneHistory[i][historyIndex] = (float)(zoneFrame[i] * 1000.0);
+
+    memcpy(counterShown, counterFrame, sizeof(counterShown));
+    memset(zoneFrame, 0, sizeof(zoneFrame));
+    memset(counterFrame, 0, sizeof(counterFrame));
+
+    historyIndex = (historyIndex + 1) % PROFILE_HISTORY;
+
+    if (historyCount < PROFILE_HISTORY)
+        historyCount++;
+}
+
+void DrawProfiler(void)
+{
+    if (IsKeyPressed(KEY_F3))
+        profilerVisible = !profilerVisible;
+
+    if (!profilerVisible)
+        return;
+
+    const int fontSize = 20;
+    const int lineHeight = fontSize + 4;
+    int x = GetScreenWidth() - 330;
+    int y = 10;
+
+    DrawRectangle(x - 10, y - 5, 330, (PROFILE_ZONE_COUNT + PROFILE_COUNTER_COUNT + 3) * lineHeight, CLITERAL(Color){0, 0, 0, 180});
+
+    // The default font is proportional, so every column gets its own DrawText()
+    DrawText("zone (ms)", x, y, fontSize, YELLOW);
+    DrawText("avg", x + 150, y, fontSize, YELLOW);
+    DrawText("max", x + 230, y, fontSize, YELLOW);
+    y += lineHeight;
+
+    for (int i = 0; i < PROFILE_ZONE_COUNT; i++)
+    {
+        float sum = 0.0f;
+        float peak = 0.0f;
+
+        for (int j = 0; j < historyCount; j++)
+        {
+            sum += zoneHistory[i][j];
+
+            if (zoneHistory[i][j] > peak)
+                peak = zoneHistory[i][j];
+        }
+
+        float average = (historyCount > 0) ? sum / historyCount : 0.0f;
+
+        DrawText(zoneNames[i], x, y, fontSize, RAYWHITE);
+        DrawText(TextFormat("%.3f", average), x + 150, y, fontSize, RAYWHITE);
+        DrawText(TextFormat("%.3f", peak), x + 230, y, fontSize, RAYWHITE);
+        y += lineHeight;
+    }
+
+    y += lineHeight;
+
+    for (int i = 0; i < PROFILE_COUNTER_COUNT; i++)
+    {
+        DrawText(counterNames[i], x, y, fontSize, RAYWHITE);
+        DrawText(TextFormat("%i", counterShown[i]), x + 150, y, fontSize, RAYWHITE);
+        y += lineHeight;
+    }
+
+    DrawText(TextFormat("%i fps", GetFPS()), x, y, fontSize, LIME);
+}
+
+#endif // ENABLE_PROFILER
@@ -0,0 +1,66 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "game.h"
+
+//----------------------------------------------------------------------------------
+// Some Defines
+//----------------------------------------------------------------------------------
+#define PROFILE_HISTORY 120 // Frames the rolling average and peak are taken over
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// Zones below GAME_STAGE_COUNT are the simulation stages, reported by the core
+// through GameHooks.onStage; the rest are timed by the frontend
+typedef enum
+{
+    PROFILE_ZONE_UPDATE = GAME_STAGE_COUNT, // Every tick run this frame
+    PROFILE_ZONE_DRAW,
+    PROFILE_ZONE_COUNT
+} ProfileZone;
+
+typedef enum
+{
+    PROFILE_COUNTER_BATCHES = 0, // Sprite queue flush, one per texture switch
+    PROFILE_COUNTER_VERTICES,
+    PROFILE_COUNTER_TEXTURES, // Live entries in the texture cache
+    PROFILE_COUNTER_ENEMIES,
+    PROFILE_COUNTER_SHOOTS,
+    PROFILE_COUNTER_RENDER_SCALE, // Frame target size in percent of the virtual resolution
+    PROFILE_COUNTER_VOICES, // Pooled sound effects playing
+    PROFILE_COUNTER_COUNT
+} ProfileCounter;
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration
+//------------------------------------------------------------------------------------
+// Only debug builds (ENABLE_PROFILER) time anything; in release every macro is
+// empty and no call into the profiler is compiled
+#if defined(ENABLE_PROFILER)
+void ProfileBegin(int zone);
+void ProfileEnd(int zone);
+void ProfileCount(ProfileCounter counter, int amount);
+void ProfileSet(ProfileCounter counter, int value);
+void ProfileFrame(void);      // Close the frame: push zone times and counters into the history
+void DrawProfiler(void);      // F3 toggles the overlay
+void ProfileGameStage(GameStage stage, bool begin, void *userData); // For GameHooks.onStage
+
+#define PROFILE_BEGIN(zone) ProfileBegin(zone)
+#define PROFILE_END(zone) ProfileEnd(zone)
+#define PROFILE_COUNT(counter, amount) ProfileCount(counter, amount)
+#define PROFILE_SET(counter, value) ProfileSet(counter, value)
+#define PROFILE_FRAME() ProfileFrame()
+#define PROFILE_DRAW() DrawProfiler()
+#define PROFILE_HOOK(hooks) ((hooks).onStage = ProfileGameStage)
+#else
+#define PROFILE_BEGIN(zone) ((void)0)
+#define PROFILE_END(zone) ((void)0)
+#define PROFILE_COUNT(counter, amount) ((void)0)
+#define PROFILE_SET(counter, value) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#define PROFILE_DRAW() ((void)0)
+#define PROFILE_HOOK(hooks) ((void)0)
+#endif
+
+#endif // PROFILER_H
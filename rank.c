@@ -0,0 +1,1047 @@
+/*******************************************************************************************
+*
+*   Ranking store - leaderboard kept on disk as a B+tree ordered by score, with subtree
+*   counts for position queries, a clock page cache and a rollback journal for inserts
+*
+********************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rank.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h> // Not mixed with raylib.h, this file doesn't need it
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+//----------------------------------------------------------------------------------
+// Some Defines
+//----------------------------------------------------------------------------------
+#define RANK_JOURNAL_MAGIC 0x4a52444e // "NDRJ" read as a little-endian integer
+#define RANK_MAX_HEIGHT 16
+#define RANK_CACHE_PAGES 1024 // 4 MB, dirty pages stay in it until the commit
+#define RANK_CACHE_BUCKETS 2048
+#define RANK_OLD_ENTRIES 10 // Size of the version 1 and legacy files
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// Entries are ordered by score, best first, then by arrival
+typedef struct RankKey
+{
+    int score;
+    unsigned int sequence;
+} RankKey;
+
+// Page 0 of the file, every other page is a tree node
+typedef struct RankHeader
+{
+    unsigned int magic;
+    unsigned int version;
+    unsigned int pageSize;
+    unsigned int pageCount;
+    unsigned int rootPage;
+    unsigned int height; // Levels of the tree, 1 while the root is a leaf
+    unsigned int entryCount;
+    unsigned int nextSequence;
+} RankHeader;
+
+// Start of a node page, followed by count RankRecord (leaves) or RankChild (inner nodes)
+typedef struct RankNode
+{
+    unsigned short leaf;
+    unsigned short count;
+    unsigned int next; // Leaves: right sibling, 0 for the last leaf
+} RankNode;
+
+typedef struct RankRecord
+{
+    RankKey key;
+    char name[RANK_NAME_SIZE];
+} RankRecord;
+
+typedef struct RankChild
+{
+    RankKey key; // First key of the subtree, unused for the first child
+    unsigned int page;
+    unsigned int count; // Entries in the subtree
+} RankChild;
+
+#define LEAF_CAPACITY (int)((RANK_PAGE_SIZE - sizeof(RankNode)) / sizeof(RankRecord))
+#define INNER_CAPACITY (int)((RANK_PAGE_SIZE - sizeof(RankNode)) / sizeof(RankChild))
+
+// The journal holds the original copy of every page a transaction changes, as (page number,
+// page) records. The header is written last, a journal with a zero or mismatching header
+// was interrupted before the file itself was touched and is dropped.
+typedef struct RankJournalHeader
+{
+    unsigned int magic;
+    unsigned int pageCount; // Pages before the transaction, later ones are cut off
+    unsigned int recordCount;
+    unsigned int checksum; // FNV-1a of the records
+} RankJournalHeader;
+
+typedef struct RankCachePage
+{
+    unsigned char data[RANK_PAGE_SIZE]; // First, so the node structs in it are aligned
+    unsigned int number;
+    int next; // Next slot in the same bucket, -1 at the end
+    bool used;
+    bool dirty; // Never evicted, pointers to it stay valid until the commit
+    bool referenced;
+} RankCachePage;
+
+// What a node insert hands back to its parent when the node had to split
+typedef struct RankSplit
+{
+    bool split;
+    RankKey key; // First key of the new right node
+    unsigned int page;
+    unsigned int count;
+} RankSplit;
+
+// Files of older versions, imported when the board is created
+typedef struct RankV1Header
+{
+    unsigned int magic;
+    unsigned int version;
+    unsigned int count;
+    unsigned int checksum;
+} RankV1Header;
+
+typedef struct RankV1Entry
+{
+    char name[12];
+    int score;
+} RankV1Entry;
+
+typedef struct LegacyRankEntry
+{
+    char name[11];
+    int score;
+} LegacyRankEntry;
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+static FILE *rankFile = NULL;
+static char rankFileName[256] = {0};
+static char rankJournalName[272] = {0};
+static RankHeader rankHeader = {0};
+
+static RankCachePage *rankCache = NULL;
+static int rankBuckets[RANK_CACHE_BUCKETS] = {0};
+static int rankClockHand = 0;
+static int rankDirtyCount = 0;
+
+// Open transaction
+static FILE *rankJournal = NULL;
+static unsigned int rankJournalPages = 0;
+static unsigned int rankJournalRecords = 0;
+static unsigned int rankJournalChecksum = 0;
+
+//------------------------------------------------------------------------------------
+// Module Functions Definition - Files
+//------------------------------------------------------------------------------------
+static unsigned int HashBytes(unsigned int hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+
+    for (size_t i = 0; i < size; i++)
+        hash = (hash ^ bytes[i]) * 16777619u;
+
+    return hash;
+}
+
+static bool SeekPage(FILE *file, unsigned int number)
+{
+    long long offset = (long long)number * RANK_PAGE_SIZE;
+
+#if defined(_WIN32)
+    return (_fseeki64(file, offset, SEEK_SET) == 0);
+#else
+    return (fseeko(file, (off_t)offset, SEEK_SET) == 0);
+#endif
+}
+
+static bool SyncFile(FILE *file)
+{
+    if (fflush(file) != 0)
+        return false;
+
+#if defined(_WIN32)
+    return (_commit(_fileno(file)) == 0);
+#else
+    return (fsync(fileno(file)) == 0);
+#endif
+}
+
+static bool TruncateFile(FILE *file, unsigned int pageCount)
+{
+    long long size = (long long)pageCount * RANK_PAGE_SIZE;
+
+    if (fflush(file) != 0)
+        return false;
+
+#if defined(_WIN32)
+    return (_chsize_s(_fileno(file), size) == 0);
+#else
+    return (ftruncate(fileno(file), (off_t)size) == 0);
+#endif
+}
+
+// Makes creates, renames and deletes in the working directory durable
+static void SyncDirectory(void)
+{
+#if !defined(_WIN32)
+    int directory = open(".", O_RDONLY);
+
+    if (directory >= 0)
+    {
+        fsync(directory);
+        close(directory);
+    }
+#endif
+}
+
+static bool ReplaceFile(const char *from, const char *to)
+{
+#if defined(_WIN32)
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+    bool renamed = (rename(from, to) == 0);
+
+    if (renamed)
+        SyncDirectory();
+
+    return renamed;
+#endif
+}
+
+static bool ReadHeader(void)
+{
+    bool valid = SeekPage(rankFile, 0) && (fread(&rankHeader, sizeof(RankHeader), 1, rankFile) == 1) &&
+                 (rankHeader.magic == RANK_MAGIC) && (rankHeader.version == RANK_VERSION) &&
+                 (rankHeader.pageSize == RANK_PAGE_SIZE) && (rankHeader.rootPage > 0) &&
+                 (rankHeader.rootPage < rankHeader.pageCount) &&
+                 (rankHeader.height >= 1) && (rankHeader.height <= RANK_MAX_HEIGHT);
+
+    if (!valid)
+        rankHeader = (RankHeader){0};
+
+    return valid;
+}
+
+// An empty board is a header and one empty leaf, written aside and renamed into place
+static bool CreateRankFile(void)
+{
+    static unsigned char pages[2][RANK_PAGE_SIZE];
+    char tempFileName[sizeof(rankFileName) + 4];
+
+    memset(pages, 0, sizeof(pages));
+
+    RankHeader header = {RANK_MAGIC, RANK_VERSION, RANK_PAGE_SIZE, 2, 1, 1, 0, 0};
+    RankNode root = {1, 0, 0};
+
+    memcpy(pages[0], &header, sizeof(RankHeader));
+    memcpy(pages[1], &root, sizeof(RankNode));
+
+    snprintf(tempFileName, sizeof(tempFileName), "%s.tmp", rankFileName);
+
+    FILE *file = fopen(tempFileName, "wb");
+
+    if (file == NULL)
+        return false;
+
+    bool written = (fwrite(pages, RANK_PAGE_SIZE, 2, file) == 2) && SyncFile(file);
+
+    written = (fclose(file) == 0) && written;
+
+    // A journal left without its board belongs to nothing
+    remove(rankJournalName);
+
+    written = written && ReplaceFile(tempFileName, rankFileName);
+
+    if (!written)
+        remove(tempFileName);
+
+    return written;
+}
+
+// Puts back the pages of an interrupted transaction if its journal is complete. Returns
+// false when a journal is left behind, the board must not be used or written then.
+static bool ReplayJournal(void)
+{
+    FILE *journal = fopen(rankJournalName, "rb");
+
+    if (journal == NULL)
+        return true;
+
+    static unsigned char page[RANK_PAGE_SIZE];
+    RankJournalHeader header = {0};
+    unsigned int number = 0;
+    unsigned int checksum = 2166136261u;
+    unsigned int records = 0;
+
+    bool valid = (fread(&header, sizeof(RankJournalHeader), 1, journal) == 1) && (header.magic == RANK_JOURNAL_MAGIC);
+
+    for (; valid && (records < header.recordCount); records++)
+    {
+        if ((fread(&number, sizeof(number), 1, journal) != 1) || (fread(page, RANK_PAGE_SIZE, 1, journal) != 1))
+            break;
+
+        checksum = HashBytes(HashBytes(checksum, &number, sizeof(number)), page, RANK_PAGE_SIZE);
+    }
+
+    valid = valid && (records == header.recordCount) && (checksum == header.checksum);
+
+    if (valid)
+    {
+        fseek(journal, sizeof(RankJournalHeader), SEEK_SET);
+
+        for (unsigned int i = 0; valid && (i < header.recordCount); i++)
+        {
+            valid = (fread(&number, sizeof(number), 1, journal) == 1) && (fread(page, RANK_PAGE_SIZE, 1, journal) == 1) &&
+                    SeekPage(rankFile, number) && (fwrite(page, RANK_PAGE_SIZE, 1, rankFile) == 1);
+        }
+
+        valid = valid && TruncateFile(rankFile, header.pageCount) && SyncFile(rankFile);
+    }
+
+    fclose(journal);
+
+    // A replay that failed halfway is retried on the next open
+    if (!valid && (header.magic == RANK_JOURNAL_MAGIC) && (checksum == header.checksum))
+        return false;
+
+    remove(rankJournalName);
+    SyncDirectory();
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------
+// Module Functions Definition - Page cache
+//------------------------------------------------------------------------------------
+static void ResetCache(void)
+{
+    for (int i = 0; i < RANK_CACHE_PAGES; i++)
+        rankCache[i].used = false;
+
+    for (int i = 0; i < RANK_CACHE_BUCKETS; i++)
+        rankBuckets[i] = -1;
+
+    rankClockHand = 0;
+    rankDirtyCount = 0;
+}
+
+static int FindCachePage(unsigned int number)
+{
+    for (int slot = rankBuckets[number % RANK_CACHE_BUCKETS]; slot >= 0; slot = rankCache[slot].next)
+    {
+        if (rankCache[slot].number == number)
+            return slot;
+    }
+
+    return -1;
+}
+
+static void UnlinkCachePage(int slot)
+{
+    int *link = &rankBuckets[rankCache[slot].number % RANK_CACHE_BUCKETS];
+
+    while (*link != slot)
+        link = &rankCache[*link].next;
+
+    *link = rankCache[slot].next;
+    rankCache[slot].used = false;
+}
+
+static int TakeCacheSlot(unsigned int number)
+{
+    // Clock sweep: a page survives one pass after its last use, dirty pages are skipped
+    for (int pass = 0; pass < 2 * RANK_CACHE_PAGES; pass++)
+    {
+        int slot = rankClockHand;
+        RankCachePage *page = &rankCache[slot];
+
+        rankClockHand = (rankClockHand + 1) % RANK_CACHE_PAGES;
+
+        if (page->used && (page->dirty || page->referenced))
+        {
+            page->referenced = false;
+            continue;
+        }
+
+        if (page->used)
+            UnlinkCachePage(slot);
+
+        page->number = number;
+        page->next = rankBuckets[number % RANK_CACHE_BUCKETS];
+        page->used = true;
+        page->dirty = false;
+        page->referenced = true;
+        rankBuckets[number % RANK_CACHE_BUCKETS] = slot;
+
+        return slot;
+    }
+
+    return -1;
+}
+
+// Returned data stays valid until the next fetch, or until the commit once it is dirty
+static int FetchPage(unsigned int number)
+{
+    if (number >= rankHeader.pageCount)
+        return -1;
+
+    int slot = FindCachePage(number);
+
+    if (slot >= 0)
+    {
+        rankCache[slot].referenced = true;
+        return slot;
+    }
+
+    slot = TakeCacheSlot(number);
+
+    if (slot < 0)
+        return -1;
+
+    if (!SeekPage(rankFile, number) || (fread(rankCache[slot].data, RANK_PAGE_SIZE, 1, rankFile) != 1))
+    {
+        UnlinkCachePage(slot);
+        return -1;
+    }
+
+    return slot;
+}
+
+// Tree pages are checked as they are read, a corrupt file fails queries instead of crashing
+static RankNode *FetchNode(unsigned int number, unsigned int level)
+{
+    int slot = (number > 0) ? FetchPage(number) : -1;
+
+    if (slot < 0)
+        return NULL;
+
+    RankNode *node = (RankNode *)rankCache[slot].data;
+    bool valid = (level == 1) ? (node->leaf == 1 && node->count <= LEAF_CAPACITY) :
+                                (node->leaf == 0 && node->count >= 1 && node->count <= INNER_CAPACITY);
+
+    return valid ? node : NULL;
+}
+
+static bool JournalPage(unsigned int number, const unsigned char *data)
+{
+    bool written = (fwrite(&number, sizeof(number), 1, rankJournal) == 1) && (fwrite(data, RANK_PAGE_SIZE, 1, rankJournal) == 1);
+
+    rankJournalChecksum = HashBytes(HashBytes(rankJournalChecksum, &number, sizeof(number)), data, RANK_PAGE_SIZE);
+    rankJournalRecords++;
+
+    return written;
+}
+
+// Same as FetchPage() for a page about to change: its original goes to the journal first
+static unsigned char *WritePage(unsigned int number)
+{
+    int slot = FetchPage(number);
+
+    if (slot < 0)
+        return NULL;
+
+    RankCachePage *page = &rankCache[slot];
+
+    if (!page->dirty)
+    {
+        // Pages added by this transaction are cut off on rollback, they need no copy
+        if ((number < rankJournalPages) && !JournalPage(number, page->data))
+            return NULL;
+
+        page->dirty = true;
+        rankDirtyCount++;
+    }
+
+    return page->data;
+}
+
+static RankNode *WriteNode(unsigned int number, unsigned int level)
+{
+    RankNode *node = FetchNode(number, level);
+
+    return (node != NULL) ? (RankNode *)WritePage(number) : NULL;
+}
+
+static RankNode *NewNode(unsigned int *number, bool leaf)
+{
+    int slot = TakeCacheSlot(rankHeader.pageCount);
+
+    if (slot < 0)
+        return NULL;
+
+    *number = rankHeader.pageCount++;
+    memset(rankCache[slot].data, 0, RANK_PAGE_SIZE);
+    rankCache[slot].dirty = true;
+    rankDirtyCount++;
+
+    RankNode *node = (RankNode *)rankCache[slot].data;
+    node->leaf = leaf;
+
+    return node;
+}
+
+//------------------------------------------------------------------------------------
+// Module Functions Definition - Transactions
+//------------------------------------------------------------------------------------
+static void RollbackTransaction(void)
+{
+    if (rankJournal != NULL)
+    {
+        fclose(rankJournal);
+        rankJournal = NULL;
+    }
+
+    ResetCache();
+
+    // Without a clean file to go back to, the board closes rather than build on a broken one
+    if (!ReplayJournal() || !ReadHeader())
+    {
+        fclose(rankFile);
+        rankFile = NULL;
+        rankHeader = (RankHeader){0};
+    }
+}
+
+static bool BeginTransaction(void)
+{
+    rankJournal = fopen(rankJournalName, "wb");
+
+    if (rankJournal == NULL)
+        return false;
+
+    RankJournalHeader header = {0}; // Filled in by the commit
+
+    rankJournalPages = rankHeader.pageCount;
+    rankJournalRecords = 0;
+    rankJournalChecksum = 2166136261u;
+
+    // The header page changes with every insert
+    if ((fwrite(&header, sizeof(RankJournalHeader), 1, rankJournal) != 1) || (WritePage(0) == NULL))
+    {
+        RollbackTransaction();
+        return false;
+    }
+
+    return true;
+}
+
+static bool CommitTransaction(void)
+{
+    RankJournalHeader header = {RANK_JOURNAL_MAGIC, rankJournalPages, rankJournalRecords, rankJournalChecksum};
+
+    memcpy(rankCache[FindCachePage(0)].data, &rankHeader, sizeof(RankHeader));
+
+    // Journal on disk first, then the pages, then the journal goes away
+    bool committed = (fseek(rankJournal, 0, SEEK_SET) == 0) && (fwrite(&header, sizeof(RankJournalHeader), 1, rankJournal) == 1) &&
+                     SyncFile(rankJournal);
+
+    for (int i = 0; committed && (i < RANK_CACHE_PAGES); i++)
+    {
+        if (rankCache[i].used && rankCache[i].dirty)
+            committed = SeekPage(rankFile, rankCache[i].number) && (fwrite(rankCache[i].data, RANK_PAGE_SIZE, 1, rankFile) == 1);
+    }
+
+    committed = committed && SyncFile(rankFile);
+
+    if (!committed)
+    {
+        RollbackTransaction();
+        return false;
+    }
+
+    fclose(rankJournal);
+    rankJournal = NULL;
+    remove(rankJournalName);
+    SyncDirectory();
+
+    for (int i = 0; i < RANK_CACHE_PAGES; i++)
+        rankCache[i].dirty = false;
+
+    rankDirtyCount = 0;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------
+// Module Functions Definition - Tree
+//------------------------------------------------------------------------------------
+static inline bool KeyBefore(RankKey a, RankKey b)
+{
+    return (a.score > b.score) || ((a.score == b.score) && (a.sequence < b.sequence));
+}
+
+// First record that doesn't go before key
+static int LowerBound(const RankRecord *records, int count, RankKey key)
+{
+    int low = 0;
+    int high = count;
+
+    while (low < high)
+    {
+        int middle = (low + high) / 2;
+
+        if (KeyBefore(records[middle].key, key))
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+// Last child whose subtree starts at or before key
+static int FindChild(const RankChild *children, int count, RankKey key)
+{
+    int low = 1;
+    int high = count;
+
+    while (low < high)
+    {
+        int middle = (low + high) / 2;
+
+        if (KeyBefore(key, children[middle].key))
+            high = middle;
+        else
+            low = middle + 1;
+    }
+
+    return low - 1;
+}
+
+static bool InsertIntoLeaf(RankNode *node, const RankRecord *record, unsigned int *position, RankSplit *split)
+{
+    RankRecord *records = (RankRecord *)(node + 1);
+    int index = LowerBound(records, node->count, record->key);
+    RankNode *right = NULL;
+
+    *position += index;
+
+    // A full leaf moves its upper half to a new right sibling first
+    if (node->count == LEAF_CAPACITY)
+    {
+        right = NewNode(&split->page, true);
+
+        if (right == NULL)
+            return false;
+
+        int half = LEAF_CAPACITY / 2;
+
+        right->count = LEAF_CAPACITY - half;
+        right->next = node->next;
+        memcpy(right + 1, &records[half], right->count * sizeof(RankRecord));
+
+        node->count = half;
+        node->next = split->page;
+
+        if (index > half)
+        {
+            node = right;
+            records = (RankRecord *)(right + 1);
+            index -= half;
+        }
+    }
+
+    memmove(&records[index + 1], &records[index], (node->count - index) * sizeof(RankRecord));
+    records[index] = *record;
+    node->count++;
+
+    if (right != NULL)
+    {
+        split->split = true;
+        split->key = ((RankRecord *)(right + 1))[0].key;
+        split->count = right->count;
+    }
+
+    return true;
+}
+
+static bool InsertIntoNode(unsigned int number, unsigned int level, const RankRecord *record, unsigned int *position, RankSplit *split)
+{
+    *split = (RankSplit){0};
+
+    RankNode *node = WriteNode(number, level);
+
+    if (node == NULL)
+        return false;
+
+    if (level == 1)
+        return InsertIntoLeaf(node, record, position, split);
+
+    RankChild *children = (RankChild *)(node + 1);
+    int index = FindChild(children, node->count, record->key);
+
+    for (int i = 0; i < index; i++)
+        *position += children[i].count;
+
+    RankSplit childSplit = {0};
+
+    // The node is dirty now, so it stays put in the cache while the child is changed
+    if (!InsertIntoNode(children[index].page, level - 1, record, position, &childSplit))
+        return false;
+
+    children[index].count++;
+
+    if (!childSplit.split)
+        return true;
+
+    children[index].count -= childSplit.count;
+
+    RankChild added = {childSplit.key, childSplit.page, childSplit.count};
+    int addAt = index + 1;
+
+    if (node->count == INNER_CAPACITY)
+    {
+        RankNode *right = NewNode(&split->page, false);
+
+        if (right == NULL)
+            return false;
+
+        int half = INNER_CAPACITY / 2;
+        RankChild *rightChildren = (RankChild *)(right + 1);
+
+        right->count = INNER_CAPACITY - half;
+        memcpy(rightChildren, &children[half], right->count * sizeof(RankChild));
+        node->count = half;
+
+        if (addAt > half)
+        {
+            node = right;
+            children = rightChildren;
+            addAt -= half;
+        }
+
+        memmove(&children[addAt + 1], &children[addAt], (node->count - addAt) * sizeof(RankChild));
+        children[addAt] = added;
+        node->count++;
+
+        split->split = true;
+        split->key = rightChildren[0].key;
+        split->count = 0;
+
+        for (int i = 0; i < right->count; i++)
+            split->count += rightChildren[i].count;
+
+        return true;
+    }
+
+    memmove(&children[addAt + 1], &children[addAt], (node->count - addAt) * sizeof(RankChild));
+    children[addAt] = added;
+    node->count++;
+
+    return true;
+}
+
+static bool InsertRecord(const char *name, int score, unsigned int *position)
+{
+    RankRecord record = {{score, rankHeader.nextSequence}, {0}};
+    RankSplit split = {0};
+
+    strncpy(record.name, name, RANK_NAME_SIZE - 1);
+    *position = 0;
+
+    if (!InsertIntoNode(rankHeader.rootPage, rankHeader.height, &record, position, &split))
+        return false;
+
+    // The root split, a new root above both halves
+    if (split.split)
+    {
+        if (rankHeader.height == RANK_MAX_HEIGHT)
+            return false;
+
+        unsigned int rootPage = 0;
+        RankNode *root = NewNode(&rootPage, false);
+
+        if (root == NULL)
+            return false;
+
+        RankChild *children = (RankChild *)(root + 1);
+
+        children[0] = (RankChild){{0}, rankHeader.rootPage, rankHeader.entryCount + 1 - split.count};
+        children[1] = (RankChild){split.key, split.page, split.count};
+        root->count = 2;
+
+        rankHeader.rootPage = rootPage;
+        rankHeader.height++;
+    }
+
+    rankHeader.entryCount++;
+    rankHeader.nextSequence++;
+
+    return true;
+}
+
+// Entries that go before key
+static int CountBefore(RankKey key)
+{
+    unsigned int number = rankHeader.rootPage;
+    int count = 0;
+
+    for (unsigned int level = rankHeader.height; level > 1; level--)
+    {
+        RankNode *node = FetchNode(number, level);
+
+        if (node == NULL)
+            return -1;
+
+        RankChild *children = (RankChild *)(node + 1);
+        int index = FindChild(children, node->count, key);
+
+        for (int i = 0; i < index; i++)
+            count += children[i].count;
+
+        number = children[index].page;
+    }
+
+    RankNode *leaf = FetchNode(number, 1);
+
+    return (leaf != NULL) ? count + LowerBound((RankRecord *)(leaf + 1), leaf->count, key) : -1;
+}
+
+static void ImportOldRankings(void)
+{
+    RankEntry entries[RANK_OLD_ENTRIES] = {0};
+    int count = 0;
+    FILE *file = fopen(RANK_V1_FILE, "rb");
+    RankV1Header header = {0};
+    RankV1Entry oldEntries[RANK_OLD_ENTRIES] = {0};
+
+    // Same checks as the version 1 store made on load, a torn or corrupt file isn't imported
+    bool valid = (file != NULL) && (fread(&header, sizeof(RankV1Header), 1, file) == 1) &&
+                 (header.magic == RANK_MAGIC) && (header.version == 1) && (header.count <= RANK_OLD_ENTRIES) &&
+                 (fread(oldEntries, sizeof(RankV1Entry), header.count, file) == header.count);
+
+    if (valid && (HashBytes(2166136261u, oldEntries, header.count * sizeof(RankV1Entry)) != header.checksum))
+    {
+        fprintf(stderr, "RANK: [%s] fails its checksum, not imported\n", RANK_V1_FILE);
+        valid = false;
+    }
+
+    if (valid)
+    {
+        for (; count < (int)header.count; count++)
+        {
+            memcpy(entries[count].name, oldEntries[count].name, sizeof(oldEntries[count].name) - 1);
+            entries[count].score = oldEntries[count].score;
+        }
+    }
+    else
+    {
+        if (file != NULL)
+            fclose(file);
+
+        file = fopen(RANK_LEGACY_FILE, "rb");
+
+        LegacyRankEntry entry = {0};
+
+        // Unused slots were written as empty names with no score
+        for (int i = 0; (file != NULL) && (i < RANK_OLD_ENTRIES) && (fread(&entry, sizeof(LegacyRankEntry), 1, file) == 1); i++)
+        {
+            if (entry.name[0] != '\0' || entry.score != 0)
+            {
+                memcpy(entries[count].name, entry.name, sizeof(entry.name) - 1);
+                entries[count].score = entry.score;
+                count++;
+            }
+        }
+    }
+
+    if (file != NULL)
+        fclose(file);
+
+    // Best first already, so ties keep their order. The old files are left alone.
+    InsertRankScores(entries, count, NULL);
+}
+
+//------------------------------------------------------------------------------------
+// Module Functions Definition - Public
+//------------------------------------------------------------------------------------
+bool OpenRanking(const char *fileName)
+{
+    CloseRanking();
+
+    snprintf(rankFileName, sizeof(rankFileName), "%s", fileName);
+    snprintf(rankJournalName, sizeof(rankJournalName), "%s-journal", fileName);
+
+    rankCache = (RankCachePage *)calloc(RANK_CACHE_PAGES, sizeof(RankCachePage));
+
+    if (rankCache == NULL)
+        return false;
+
+    ResetCache();
+
+    rankFile = fopen(rankFileName, "r+b");
+
+    bool created = (rankFile == NULL) && CreateRankFile();
+
+    if (created)
+        rankFile = fopen(rankFileName, "r+b");
+
+    if (rankFile == NULL)
+    {
+        CloseRanking();
+        return false;
+    }
+
+    if (!ReplayJournal() || !ReadHeader())
+    {
+        CloseRanking();
+        return false;
+    }
+
+    if (created)
+        ImportOldRankings();
+
+    return true;
+}
+
+void CloseRanking(void)
+{
+    if (rankJournal != NULL)
+        RollbackTransaction();
+
+    if (rankFile != NULL)
+        fclose(rankFile);
+
+    free(rankCache);
+
+    rankFile = NULL;
+    rankCache = NULL;
+    rankHeader = (RankHeader){0};
+}
+
+int InsertRankScore(const char *name, int score)
+{
+    unsigned int position = 0;
+
+    if ((rankFile == NULL) || !BeginTransaction())
+        return -1;
+
+    if (!InsertRecord(name, score, &position))
+    {
+        RollbackTransaction();
+        return -1;
+    }
+
+    return CommitTransaction() ? (int)position : -1;
+}
+
+int InsertRankScores(const RankEntry *entries, int count, int *positions)
+{
+    int committed = 0;
+
+    for (int i = 0; (positions != NULL) && (i < count); i++)
+        positions[i] = -1;
+
+    if ((rankFile == NULL) || (count <= 0) || !BeginTransaction())
+        return 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        unsigned int position = 0;
+
+        // One insert dirties at most two pages per level and a new root
+        if (rankDirtyCount + 2 * (int)rankHeader.height + 2 > RANK_CACHE_PAGES)
+        {
+            if (!CommitTransaction())
+                break;
+
+            committed = i;
+
+            if (!BeginTransaction())
+                break;
+        }
+
+        if (!InsertRecord(entries[i].name, entries[i].score, &position))
+        {
+            RollbackTransaction();
+            break;
+        }
+
+        if (positions != NULL)
+            positions[i] = (int)position;
+    }
+
+    if ((rankJournal != NULL) && CommitTransaction())
+        committed = count;
+
+    for (int i = committed; (positions != NULL) && (i < count); i++)
+        positions[i] = -1;
+
+    return committed;
+}
+
+int GetRankCount(void)
+{
+    return (int)rankHeader.entryCount;
+}
+
+int GetScoreRank(int score)
+{
+    if (rankFile == NULL)
+        return 0;
+
+    return CountBefore((RankKey){score, 0});
+}
+
+int GetRankPage(int first, RankEntry *entries, int count)
+{
+    if ((rankFile == NULL) || (first < 0) || (first >= (int)rankHeader.entryCount) || (count <= 0))
+        return 0;
+
+    // Walk down by subtree counts to the leaf holding position first
+    unsigned int number = rankHeader.rootPage;
+    unsigned int remaining = (unsigned int)first;
+
+    for (unsigned int level = rankHeader.height; level > 1; level--)
+    {
+        RankNode *node = FetchNode(number, level);
+
+        if (node == NULL)
+            return 0;
+
+        RankChild *children = (RankChild *)(node + 1);
+        int index = 0;
+
+        while ((index < node->count - 1) && (remaining >= children[index].count))
+            remaining -= children[index++].count;
+
+        number = children[index].page;
+    }
+
+    // Then along the leaf chain
+    int copied = 0;
+    RankNode *leaf = FetchNode(number, 1);
+
+    while ((leaf != NULL) && (copied < count))
+    {
+        RankRecord *records = (RankRecord *)(leaf + 1);
+
+        for (; (remaining < leaf->count) && (copied < count); remaining++, copied++)
+        {
+            memcpy(entries[copied].name, records[remaining].name, RANK_NAME_SIZE);
+            entries[copied].name[RANK_NAME_SIZE - 1] = '\0';
+            entries[copied].score = records[remaining].key.score;
+        }
+
+        remaining = 0;
+        leaf = ((copied < count) && (leaf->next != 0)) ? FetchNode(leaf->next, 1) : NULL;
+    }
+
+    return copied;
+}
@@ -0,0 +1,52 @@
+#ifndef RANK_H
+#define RANK_H
+
+#include <stdbool.h>
+
+//----------------------------------------------------------------------------------
+// Some Defines
+//----------------------------------------------------------------------------------
+#define RANK_FILE "rankscore.db"
+#define RANK_V1_FILE "rankscore.dat"     // Ten-entry store of version 1, imported once
+#define RANK_LEGACY_FILE "rankscore.bin" // Headerless ten-entry file before that, imported once
+#define RANK_MAGIC 0x4b52444e // "NDRK" read as a little-endian integer
+#define RANK_VERSION 2
+#define RANK_PAGE_SIZE 4096
+#define RANK_NAME_SIZE 32 // Up to 31 characters and the terminator
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct RankEntry
+{
+    char name[RANK_NAME_SIZE];
+    int score;
+} RankEntry;
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration
+//------------------------------------------------------------------------------------
+// The leaderboard is a B+tree of RANK_PAGE_SIZE pages ordered by score, best first, then
+// by arrival. Inner nodes keep the entry count of each subtree, so positions are found in
+// O(log n) whatever the size. Writes go through a rollback journal (fileName-journal): a
+// crash leaves the board as it was before or after the interrupted insert.
+//
+// Opening replays a leftover journal, creates the file when missing (importing the
+// version 1 or legacy ten-entry files) and returns false when the board can't be used.
+bool OpenRanking(const char *fileName);
+void CloseRanking(void);
+
+// Returns the position of the new entry (0 is the best score) or -1 on failure
+int InsertRankScore(const char *name, int score);
+
+// Bulk insert in as few transactions as the page cache allows. Returns how many entries
+// were committed, a failure rolls back only the transaction it happened in. positions, if
+// not NULL, receives where each entry went when it was inserted (later entries of the
+// batch may push it down), -1 for the ones that weren't committed.
+int InsertRankScores(const RankEntry *entries, int count, int *positions);
+
+int GetRankCount(void);
+int GetScoreRank(int score); // Entries with a better score, the position a new one would take
+int GetRankPage(int first, RankEntry *entries, int count); // Copies entries from position first on, returns how many
+
+#endif // RANK_H
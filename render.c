@@ -0,0 +1,617 @@
+/*******************************************************************************************
+*
+*   Sprite queue - collects textured quads for a frame, sorts them by layer and texture
+*   and sends them to rlgl in as few texture switches as possible
+*
+*   Cached layers - render textures for the parts of the screen that only change on
+*   events (background, HUD), so they cost one queued quad per frame
+*
+*   Text cache - glyph quads and widths of the strings drawn every frame, so they are
+*   laid out once instead of on every DrawText() and MeasureText()
+*
+*   Frame target - virtual resolution render texture, letterboxed to the window, with a
+*   governor that trades internal resolution for frame time
+*
+********************************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "render.h"
+#include "rlgl.h"
+
+//----------------------------------------------------------------------------------
+// Some Defines
+//----------------------------------------------------------------------------------
+#define SPRITE_QUEUE_CAPACITY 256 // Initial capacity, grows on demand
+#define SPRITE_CHUNK_SIZE 1024 // Sprites sent between batch limit checks, well under rlgl's default buffer
+#define TEXT_CACHE_SLOTS 128 // Must be a power of two
+#define TEXT_CACHE_MAX_LENGTH 64 // Longer strings go straight to DrawText()
+#define DEFAULT_FONT_SIZE 10 // Smallest size DrawText() uses, it also sets the spacing
+#define FRAME_SCALE_LEVELS 5 // Internal resolution steps, see frameScales
+#define FRAME_TIME_SMOOTHING 0.05f // Weight of the newest frame in the averages
+#define FRAME_OVER_BUDGET 1.2f // Average frame time that makes the governor drop a level
+#define FRAME_BUSY_HEADROOM 0.6f // Average busy time under which it may climb back
+#define FRAME_DROP_COOLDOWN 1.0f // Seconds between two drops, so the averages catch up
+#define FRAME_RAISE_DELAY 2.0f // Seconds of headroom before climbing, doubles after each failed climb
+#define FRAME_RAISE_DELAY_MAX 32.0f
+#define FRAME_RAISE_TRIAL 8.0f // A drop this soon after a climb means the climb failed
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct QueuedSprite
+{
+    unsigned long long key; // Layer, texture id and submission order, sorted ascending
+    unsigned int textureId;
+    float u0, v0, u1, v1;
+    float x0, y0, x1, y1;
+    Color tint;
+} QueuedSprite;
+
+typedef struct TextQuad
+{
+    float u0, v0, u1, v1;
+    float x0, y0, x1, y1; // Relative to the text position
+} TextQuad;
+
+typedef struct CachedText
+{
+    unsigned int hash; // 0 marks an empty slot
+    int fontSize;
+    char text[TEXT_CACHE_MAX_LENGTH];
+    int width; // What MeasureText() returns
+    int quadCount;
+    TextQuad *quads;
+} CachedText;
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+static QueuedSprite *queue = NULL;
+static int queueCount = 0;
+static int queueCapacity = 0;
+static int batchCount = 0;
+static int vertexCount = 0;
+
+static RenderTexture2D cachedLayers[CACHED_LAYER_COUNT] = {0};
+static bool cachedLayerDirty[CACHED_LAYER_COUNT] = {0};
+
+static CachedText textCache[TEXT_CACHE_SLOTS] = {0};
+static int textCacheCount = 0;
+static unsigned int textFontId = 0; // Font texture the cached quads were built for
+
+static const float frameScales[FRAME_SCALE_LEVELS] = {1.0f, 0.875f, 0.75f, 0.625f, 0.5f};
+static RenderTexture2D frameTarget = {0};
+static int virtualWidth = 0;
+static int virtualHeight = 0;
+static int frameLevel = 0; // Index in frameScales
+static Rectangle frameBox = {0}; // Where the target lands in the window
+static float frameTimeAverage = 0.0f;
+static float busyTimeAverage = 0.0f;
+static float frameCooldown = 0.0f;
+static float frameHeadroom = 0.0f; // Seconds spent with headroom at the current level
+static float frameRaiseDelay = FRAME_RAISE_DELAY;
+static float frameSinceRaise = FRAME_RAISE_TRIAL;
+
+//------------------------------------------------------------------------------------
+// Module Functions Definition
+//------------------------------------------------------------------------------------
+void QueueSprite(Texture2D texture, Rectangle src, Rectangle dest, Vector2 origin, SpriteLayer layer, Color tint)
+{
+    if (texture.id == 0)
+        return;
+
+    if (queueCount == queueCapacity)
+    {
+        int grown = (queueCapacity > 0) ? queueCapacity * 2 : SPRITE_QUEUE_CAPACITY;
+        QueuedSprite *resized = (QueuedSprite *)realloc(queue, grown * sizeof(QueuedSprite));
+
+        if (resized == NULL)
+            return;
+
+        queue = resized;
+        queueCapacity = grown;
+    }
+
+    QueuedSprite *sprite = &queue[queueCount];
+
+    // Negative source sizes flip the sprite, like DrawTexturePro()
+    bool flipX = (src.width < 0);
+    bool flipY = (src.height < 0);
+
+    if (flipX)
+        src.width *= -1;
+
+    if (flipY)
+        src.height *= -1;
+
+    sprite->key = ((unsigned long long)layer << 56) | ((unsigned long long)(texture.id & 0xffffff) << 32) | (unsigned int)queueCount;
+    sprite->textureId = texture.id;
+    sprite->u0 = (flipX ? src.x + src.width : src.x) / texture.width;
+    sprite->u1 = (flipX ? src.x : src.x + src.width) / texture.width;
+    sprite->v0 = (flipY ? src.y + src.height : src.y) / texture.height;
+    sprite->v1 = (flipY ? src.y : src.y + src.height) / texture.height;
+    sprite->x0 = dest.x - origin.x;
+    sprite->y0 = dest.y - origin.y;
+    sprite->x1 = sprite->x0 + dest.width;
+    sprite->y1 = sprite->y0 + dest.height;
+    sprite->tint = tint;
+
+    queueCount++;
+}
+
+static int CompareSprites(const void *a, const void *b)
+{
+    unsigned long long x = ((const QueuedSprite *)a)->key;
+    unsigned long long y = ((const QueuedSprite *)b)->key;
+
+    return (x > y) - (x < y);
+}
+
+void FlushSprites(void)
+{
+    batchCount = 0;
+    vertexCount = 0;
+
+    if (queueCount == 0)
+        return;
+
+    qsort(queue, queueCount, sizeof(QueuedSprite), CompareSprites);
+
+    int start = 0;
+
+    while (start < queueCount)
+    {
+        // One run of sprites sharing a texture goes out as one batch
+        int end = start;
+
+        while (end < queueCount && queue[end].textureId == queue[start].textureId)
+            end++;
+
+        // Sent in chunks so rlgl can flush its vertex buffer in between instead of dropping vertices
+        for (int chunk = start; chunk < end; chunk += SPRITE_CHUNK_SIZE)
+        {
+            int chunkEnd = (end - chunk > SPRITE_CHUNK_SIZE) ? chunk + SPRITE_CHUNK_SIZE : end;
+
+            rlCheckRenderBatchLimit(4 * (chunkEnd - chunk));
+
+            rlSetTexture(queue[start].textureId);
+            rlBegin(RL_QUADS);
+            rlNormal3f(0.0f, 0.0f, 1.0f);
+
+            for (int i = chunk; i < chunkEnd; i++)
+            {
+                const QueuedSprite *sprite = &queue[i];
+
+                rlColor4ub(sprite->tint.r, sprite->tint.g, sprite->tint.b, sprite->tint.a);
+
+                rlTexCoord2f(sprite->u0, sprite->v0);
+                rlVertex2f(sprite->x0, sprite->y0);
+
+                rlTexCoord2f(sprite->u0, sprite->v1);
+                rlVertex2f(sprite->x0, sprite->y1);
+
+                rlTexCoord2f(sprite->u1, sprite->v1);
+                rlVertex2f(sprite->x1, sprite->y1);
+
+                rlTexCoord2f(sprite->u1, sprite->v0);
+                rlVertex2f(sprite->x1, sprite->y0);
+            }
+
+            rlEnd();
+            rlSetTexture(0);
+        }
+
+        batchCount++;
+        vertexCount += 4 * (end - start);
+        start = end;
+    }
+
+    queueCount = 0;
+}
+
+void UnloadSpriteQueue(void)
+{
+    free(queue);
+    queue = NULL;
+    queueCount = 0;
+    queueCapacity = 0;
+}
+
+int GetSpriteBatchCount(void)
+{
+    return batchCount;
+}
+
+int GetSpriteVertexCount(void)
+{
+    return vertexCount;
+}
+
+//------------------------------------------------------------------------------------
+// Cached layers
+//------------------------------------------------------------------------------------
+bool BeginCachedLayer(CachedLayer layer, int width, int height)
+{
+    RenderTexture2D *target = &cachedLayers[layer];
+
+    if (target->id == 0 || target->texture.width != width || target->texture.height != height)
+    {
+        if (target->id != 0)
+            UnloadRenderTexture(*target);
+
+        *target = LoadRenderTexture(width, height);
+        cachedLayerDirty[layer] = true;
+    }
+
+    if (!cachedLayerDirty[layer] || target->id == 0)
+        return false;
+
+    cachedLayerDirty[layer] = false;
+
+    BeginTextureMode(*target);
+    ClearBackground(BLANK);
+
+    return true;
+}
+
+void EndCachedLayer(void)
+{
+    FlushSprites();
+    EndTextureMode();
+}
+
+void InvalidateCachedLayer(CachedLayer layer)
+{
+    cachedLayerDirty[layer] = true;
+}
+
+void QueueCachedLayer(CachedLayer layer, SpriteLayer spriteLayer)
+{
+    Texture2D texture = cachedLayers[layer].texture;
+
+    // Render textures are stored bottom-up, the negative height flips them back
+    QueueSprite(texture, (Rectangle){0, 0, texture.width, -texture.height},
+                (Rectangle){0, 0, texture.width, texture.height}, (Vector2){0, 0}, spriteLayer, WHITE);
+}
+
+void UnloadCachedLayers(void)
+{
+    for (int i = 0; i < CACHED_LAYER_COUNT; i++)
+    {
+        if (cachedLayers[i].id != 0)
+            UnloadRenderTexture(cachedLayers[i]);
+
+        cachedLayers[i] = (RenderTexture2D){0};
+        cachedLayerDirty[i] = false;
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Text cache
+//------------------------------------------------------------------------------------
+static unsigned int HashText(const char *text, int fontSize)
+{
+    unsigned int hash = 2166136261u; // FNV-1a
+
+    for (const unsigned char *c = (const unsigned char *)text; *c != '\0'; c++)
+        hash = (hash ^ *c) * 16777619u;
+
+    hash = (hash ^ (unsigned int)fontSize) * 16777619u;
+
+    return (hash != 0) ? hash : 1;
+}
+
+// Lay the text out the way DrawTextEx() and MeasureTextEx() do in raylib 4.2
+static bool LayoutText(CachedText *entry, Font font)
+{
+    int length = (int)strlen(entry->text);
+    int spacing = entry->fontSize / DEFAULT_FONT_SIZE;
+    float scale = (float)entry->fontSize / font.baseSize;
+    float padding = (float)font.glyphPadding;
+
+    entry->quads = (TextQuad *)malloc((length > 0 ? length : 1) * sizeof(TextQuad));
+
+    if (entry->quads == NULL)
+        return false;
+
+    entry->quadCount = 0;
+
+    float offsetX = 0.0f;
+    float offsetY = 0.0f;
+    float lineWidth = 0.0f; // Unscaled, like MeasureTextEx()
+    float widestLine = 0.0f;
+    int lineGlyphs = 0;
+    int widestGlyphs = 0;
+
+    for (int i = 0; i < length;)
+    {
+        int bytes = 0;
+        int codepoint = GetCodepoint(&entry->text[i], &bytes);
+        int index = GetGlyphIndex(font, codepoint);
+        Rectangle rec = font.recs[index];
+        GlyphInfo glyph = font.glyphs[index];
+
+        if (codepoint == 0x3f)
+            bytes = 1;
+
+        i += (bytes > 0) ? bytes : 1;
+
+        if (codepoint == '\n')
+        {
+            if (lineWidth > widestLine)
+                widestLine = lineWidth;
+
+            offsetX = 0.0f;
+            offsetY += (int)((font.baseSize + font.baseSize / 2) * scale);
+            lineWidth = 0.0f;
+            lineGlyphs = 0;
+            continue;
+        }
+
+        if (codepoint != ' ' && codepoint != '\t')
+        {
+            TextQuad *quad = &entry->quads[entry->quadCount++];
+
+            quad->u0 = (rec.x - padding) / font.texture.width;
+            quad->v0 = (rec.y - padding) / font.texture.height;
+            quad->u1 = (rec.x + rec.width + padding) / font.texture.width;
+            quad->v1 = (rec.y + rec.height + padding) / font.texture.height;
+            quad->x0 = offsetX + (glyph.offsetX - padding) * scale;
+            quad->y0 = offsetY + (glyph.offsetY - padding) * scale;
+            quad->x1 = quad->x0 + (rec.width + 2.0f * padding) * scale;
+            quad->y1 = quad->y0 + (rec.height + 2.0f * padding) * scale;
+        }
+
+        offsetX += ((glyph.advanceX != 0) ? glyph.advanceX : rec.width) * scale + spacing;
+        lineWidth += (glyph.advanceX != 0) ? glyph.advanceX : rec.width + glyph.offsetX;
+
+        if (++lineGlyphs > widestGlyphs)
+            widestGlyphs = lineGlyphs;
+    }
+
+    if (lineWidth > widestLine)
+        widestLine = lineWidth;
+
+    entry->width = (widestGlyphs > 0) ? (int)(widestLine * scale + (widestGlyphs - 1) * spacing) : 0;
+
+    return true;
+}
+
+// Returns NULL when the text can't be cached, callers fall back to raylib
+static const CachedText *FindCachedText(const char *text, int fontSize)
+{
+    if (fontSize < DEFAULT_FONT_SIZE)
+        fontSize = DEFAULT_FONT_SIZE;
+
+    if (strlen(text) >= TEXT_CACHE_MAX_LENGTH)
+        return NULL;
+
+    Font font = GetFontDefault();
+
+    if (font.texture.id == 0)
+        return NULL;
+
+    // Quads point into the font texture, a new one invalidates all of them
+    if (font.texture.id != textFontId)
+    {
+        UnloadTextCache();
+        textFontId = font.texture.id;
+    }
+
+    unsigned int hash = HashText(text, fontSize);
+    int slot = hash & (TEXT_CACHE_SLOTS - 1);
+
+    while (textCache[slot].hash != 0)
+    {
+        const CachedText *entry = &textCache[slot];
+
+        if (entry->hash == hash && entry->fontSize == fontSize && strcmp(entry->text, text) == 0)
+            return entry;
+
+        slot = (slot + 1) & (TEXT_CACHE_SLOTS - 1);
+    }
+
+    // Strings that change every few frames (typed names) would fill it up eventually,
+    // starting over is cheaper than tracking what is still in use
+    if (textCacheCount >= TEXT_CACHE_SLOTS * 3 / 4)
+    {
+        UnloadTextCache();
+        textFontId = font.texture.id;
+        slot = hash & (TEXT_CACHE_SLOTS - 1);
+    }
+
+    CachedText *entry = &textCache[slot];
+
+    entry->fontSize = fontSize;
+    strcpy(entry->text, text);
+
+    if (!LayoutText(entry, font))
+        return NULL;
+
+    entry->hash = hash;
+    textCacheCount++;
+
+    return entry;
+}
+
+void DrawCachedText(const char *text, int posX, int posY, int fontSize, Color color)
+{
+    const CachedText *entry = FindCachedText(text, fontSize);
+
+    if (entry == NULL)
+    {
+        DrawText(text, posX, posY, fontSize, color);
+        return;
+    }
+
+    if (entry->quadCount == 0)
+        return;
+
+    rlCheckRenderBatchLimit(4 * entry->quadCount);
+
+    rlSetTexture(textFontId);
+    rlBegin(RL_QUADS);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+    rlColor4ub(color.r, color.g, color.b, color.a);
+
+    for (int i = 0; i < entry->quadCount; i++)
+    {
+        const TextQuad *quad = &entry->quads[i];
+        float x0 = posX + quad->x0;
+        float y0 = posY + quad->y0;
+        float x1 = posX + quad->x1;
+        float y1 = posY + quad->y1;
+
+        rlTexCoord2f(quad->u0, quad->v0);
+        rlVertex2f(x0, y0);
+
+        rlTexCoord2f(quad->u0, quad->v1);
+        rlVertex2f(x0, y1);
+
+        rlTexCoord2f(quad->u1, quad->v1);
+        rlVertex2f(x1, y1);
+
+        rlTexCoord2f(quad->u1, quad->v0);
+        rlVertex2f(x1, y0);
+    }
+
+    rlEnd();
+    rlSetTexture(0);
+}
+
+int MeasureCachedText(const char *text, int fontSize)
+{
+    const CachedText *entry = FindCachedText(text, fontSize);
+
+    return (entry != NULL) ? entry->width : MeasureText(text, fontSize);
+}
+
+void UnloadTextCache(void)
+{
+    for (int i = 0; i < TEXT_CACHE_SLOTS; i++)
+        free(textCache[i].quads);
+
+    memset(textCache, 0, sizeof(textCache));
+    textCacheCount = 0;
+    textFontId = 0;
+}
+
+//------------------------------------------------------------------------------------
+// Frame target
+//------------------------------------------------------------------------------------
+static void LoadFrameTarget(void)
+{
+    if (frameTarget.id != 0)
+        UnloadRenderTexture(frameTarget);
+
+    int width = (int)(virtualWidth * frameScales[frameLevel] + 0.5f);
+    int height = (int)(virtualHeight * frameScales[frameLevel] + 0.5f);
+
+    frameTarget = LoadRenderTexture(width, height);
+    SetTextureFilter(frameTarget.texture, TEXTURE_FILTER_BILINEAR);
+}
+
+void InitFrameTarget(int width, int height)
+{
+    virtualWidth = width;
+    virtualHeight = height;
+    frameLevel = 0;
+    LoadFrameTarget();
+}
+
+void UpdateFrameTarget(float frameTime, float busyTime, float budget)
+{
+    // Governor, a single hitch (a texture upload, a window drag) shouldn't be enough to drop
+    if (frameTime > 2.0f * budget)
+        frameTime = 2.0f * budget;
+
+    frameTimeAverage += (frameTime - frameTimeAverage) * FRAME_TIME_SMOOTHING;
+    busyTimeAverage += (busyTime - busyTimeAverage) * FRAME_TIME_SMOOTHING;
+    frameCooldown -= frameTime;
+    frameSinceRaise += frameTime;
+
+    if (frameTimeAverage > budget * FRAME_OVER_BUDGET)
+    {
+        frameHeadroom = 0.0f;
+
+        if (frameCooldown <= 0.0f && frameLevel < FRAME_SCALE_LEVELS - 1)
+        {
+            // Dropping right after a climb: that level doesn't hold, wait longer next time
+            if (frameSinceRaise < FRAME_RAISE_TRIAL && frameRaiseDelay < FRAME_RAISE_DELAY_MAX)
+                frameRaiseDelay *= 2.0f;
+
+            frameLevel++;
+            frameCooldown = FRAME_DROP_COOLDOWN;
+            frameSinceRaise = FRAME_RAISE_TRIAL;
+            LoadFrameTarget();
+        }
+    }
+    else if (busyTimeAverage < budget * FRAME_BUSY_HEADROOM && frameLevel > 0)
+    {
+        frameHeadroom += frameTime;
+
+        if (frameHeadroom >= frameRaiseDelay)
+        {
+            frameLevel--;
+            frameHeadroom = 0.0f;
+            frameCooldown = FRAME_DROP_COOLDOWN;
+            frameSinceRaise = 0.0f;
+            LoadFrameTarget();
+        }
+    }
+    else
+        frameHeadroom = 0.0f;
+
+    // Letterbox, the virtual screen keeps its aspect ratio in any window
+    float scaleX = (float)GetScreenWidth() / virtualWidth;
+    float scaleY = (float)GetScreenHeight() / virtualHeight;
+    float scale = (scaleX < scaleY) ? scaleX : scaleY;
+
+    frameBox.width = virtualWidth * scale;
+    frameBox.height = virtualHeight * scale;
+    frameBox.x = (GetScreenWidth() - frameBox.width) / 2;
+    frameBox.y = (GetScreenHeight() - frameBox.height) / 2;
+
+    // The mouse reports virtual coordinates too
+    if (scale > 0.0f)
+    {
+        SetMouseOffset((int)-frameBox.x, (int)-frameBox.y);
+        SetMouseScale(1.0f / scale, 1.0f / scale);
+    }
+}
+
+void BeginFrameTarget(void)
+{
+    Camera2D camera = {0};
+
+    camera.zoom = (float)frameTarget.texture.width / virtualWidth;
+
+    BeginTextureMode(frameTarget);
+    BeginMode2D(camera);
+}
+
+void EndFrameTarget(void)
+{
+    EndMode2D();
+    EndTextureMode();
+
+    ClearBackground(BLACK);
+
+    // Render textures are stored bottom-up, the negative height flips them back
+    DrawTexturePro(frameTarget.texture, (Rectangle){0, 0, frameTarget.texture.width, -frameTarget.texture.height},
+                   frameBox, (Vector2){0, 0}, 0.0f, WHITE);
+}
+
+float GetFrameTargetScale(void)
+{
+    return frameScales[frameLevel];
+}
+
+void UnloadFrameTarget(void)
+{
+    if (frameTarget.id != 0)
+        UnloadRenderTexture(frameTarget);
+
+    frameTarget = (RenderTexture2D){0};
+}
@@ -0,0 +1,68 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+// Draw order of queued sprites, lower layers first
+typedef enum
+{
+    LAYER_BACKGROUND = 0,
+    LAYER_SHADOW,
+    LAYER_ACTORS, // Player and enemies
+    LAYER_SHOOTS,
+    LAYER_HUD,
+    LAYER_COUNT
+} SpriteLayer;
+
+// Screen-sized layers that rarely change, drawn once into a render texture and
+// blitted every frame until they are invalidated
+typedef enum
+{
+    CACHED_BACKGROUND = 0,
+    CACHED_HUD, // Hearts and score
+    CACHED_LAYER_COUNT
+} CachedLayer;
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration
+//------------------------------------------------------------------------------------
+// Same arguments as DrawTexturePro() without rotation. Sprites are drawn on the next
+// FlushSprites(), sorted by layer, then by texture, then in submission order.
+void QueueSprite(Texture2D texture, Rectangle src, Rectangle dest, Vector2 origin, SpriteLayer layer, Color tint);
+void FlushSprites(void);
+void UnloadSpriteQueue(void);
+
+// Stats of the last flush: one batch per texture switch, four vertices per sprite
+int GetSpriteBatchCount(void);
+int GetSpriteVertexCount(void);
+
+// Returns true when the layer has to be redrawn: it was invalidated, never drawn or
+// resized. The caller then draws it (queued sprites included) and calls EndCachedLayer().
+// Call it before anything is queued for the frame, the queue is flushed into the layer,
+// and outside BeginFrameTarget(), render textures don't nest.
+bool BeginCachedLayer(CachedLayer layer, int width, int height);
+void EndCachedLayer(void);
+void InvalidateCachedLayer(CachedLayer layer);
+void QueueCachedLayer(CachedLayer layer, SpriteLayer spriteLayer); // Blit at (0, 0) with the other sprites
+void UnloadCachedLayers(void);
+
+// Same output as DrawText() and MeasureText() with the default font. Each (string, size)
+// is laid out into glyph quads once and reused until the cache fills up and is reset.
+void DrawCachedText(const char *text, int posX, int posY, int fontSize, Color color);
+int MeasureCachedText(const char *text, int fontSize);
+void UnloadTextCache(void);
+
+// The game draws at a fixed virtual resolution into a render texture, which is scaled to
+// the window with letterboxing. The texture shrinks while frames run over budget and
+// grows back once there is headroom; a camera keeps the virtual coordinates unchanged.
+void InitFrameTarget(int virtualWidth, int virtualHeight);
+void UpdateFrameTarget(float frameTime, float busyTime, float budget); // Once per frame, before reading the mouse
+void BeginFrameTarget(void);
+void EndFrameTarget(void); // Draws the target to the window
+float GetFrameTargetScale(void); // Internal resolution over the virtual one
+void UnloadFrameTarget(void);
+
+#endif // RENDER_H
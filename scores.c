@@ -0,0 +1,520 @@
+/*******************************************************************************************
+*
+*   Score client - queues finished runs and writes them to the leaderboard from a worker
+*   thread, to the local board through rank.c or to a score daemon over TCP. Like the
+*   music player's commands, submissions go through a single producer, single consumer
+*   ring: the main thread only advances its head, the worker only its tail.
+*
+********************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "scores.h"
+
+#if !defined(PLATFORM_WEB)
+#define SCORE_CLIENT_THREADED // No threads on the web, the local board is written between frames
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <winsock2.h> // Not mixed with raylib.h, this file doesn't need it
+#include <windows.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+#include <pthread.h>
+#endif
+
+#include <time.h>
+
+//----------------------------------------------------------------------------------
+// Some Defines
+//----------------------------------------------------------------------------------
+#define SCORE_QUEUE_CAPACITY 16 // Must be a power of two
+#define SCORE_POLL_INTERVAL 10 // Milliseconds the worker sleeps between checks
+#define SCORE_RETRY_MIN 500 // Milliseconds before the first retry, doubled after every failure
+#define SCORE_RETRY_MAX 8000
+#define SCORE_TIMEOUT 2000 // Milliseconds the server gets to answer
+#define SCORE_REPLY_SIZE 2048
+
+#if defined(_WIN32)
+typedef SOCKET ScoreSocket;
+#define SCORE_NO_SOCKET INVALID_SOCKET
+#define CloseScoreSocket closesocket
+#else
+typedef int ScoreSocket;
+#define SCORE_NO_SOCKET -1
+#define CloseScoreSocket close
+#endif
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct ScoreSubmission
+{
+    unsigned long long id; // Same on every retry, so a run lands on the board once
+    char name[RANK_NAME_SIZE];
+    int score;
+} ScoreSubmission;
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+static ScoreSubmission submissions[SCORE_QUEUE_CAPACITY] = {0};
+static unsigned int submissionHead = 0; // Next slot the main thread writes, published with release stores
+static unsigned int submissionTail = 0; // Next slot the worker reads, published with release stores
+static unsigned int submissionSession = 0; // High half of the ids, picked when the client starts
+static unsigned int submissionSequence = 0; // Low half, main thread only
+
+// Worker's state
+static bool scoreRemote = false;
+static bool localBoardOpen = false;
+static bool boardRead = false; // The board was read once, so there are rows to show before any submission
+static ScoreBoard workerBoard = {0};
+static int retryDelay = 0;
+static double retryTime = 0.0;
+static unsigned long long localSubmitted = 0; // Last id written to the local board and where it went
+static int localPosition = -1;
+
+// What the main thread sees, copied over by PublishBoard()
+static ScoreBoard sharedBoard = {0};
+static unsigned int boardVersion = 0;
+static unsigned int boardVersionRead = 0;
+
+#if defined(SCORE_CLIENT_THREADED)
+static struct sockaddr_in scoreServer = {0};
+static pthread_t scoreThread;
+static pthread_mutex_t boardMutex = PTHREAD_MUTEX_INITIALIZER;
+static bool scoreThreadRunning = false;
+static bool scoreClientQuit = false;
+#endif
+
+//------------------------------------------------------------------------------------
+// Module Functions Definition
+//------------------------------------------------------------------------------------
+static double GetClockMilliseconds(void)
+{
+#if defined(_WIN32)
+    return (double)GetTickCount64();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+#endif
+}
+
+static void PublishBoard(void)
+{
+#if defined(SCORE_CLIENT_THREADED)
+    pthread_mutex_lock(&boardMutex);
+#endif
+    sharedBoard = workerBoard;
+    boardVersion++;
+#if defined(SCORE_CLIENT_THREADED)
+    pthread_mutex_unlock(&boardMutex);
+#endif
+}
+
+static bool ReadLocalBoard(void)
+{
+    if (!localBoardOpen)
+        localBoardOpen = OpenRanking(RANK_FILE);
+
+    if (!localBoardOpen)
+        return false;
+
+    workerBoard.topCount = GetRankPage(0, workerBoard.top, SCORE_TOP_ROWS);
+    workerBoard.total = GetRankCount();
+
+    return true;
+}
+
+static bool SubmitLocal(const ScoreSubmission *submission)
+{
+    if (!ReadLocalBoard())
+        return false;
+
+    // Only the head of the queue is ever retried, so the last id is all there is to remember
+    if (submission->id == localSubmitted)
+    {
+        workerBoard.position = localPosition;
+        return ReadLocalBoard();
+    }
+
+    int position = InsertRankScore(submission->name, submission->score);
+
+    // A failed write may leave the board closed, it is opened again on the retry
+    if (position < 0)
+    {
+        CloseRanking();
+        localBoardOpen = false;
+        return false;
+    }
+
+    workerBoard.position = position;
+    localSubmitted = submission->id;
+    localPosition = position;
+
+    return ReadLocalBoard();
+}
+
+#if defined(SCORE_CLIENT_THREADED)
+static bool ParseServer(const char *server)
+{
+    char address[64] = {0};
+    int port = SCORE_SERVER_PORT;
+    const char *colon = strchr(server, ':');
+    size_t length = (colon != NULL) ? (size_t)(colon - server) : strlen(server);
+
+    if (length == 0 || length >= sizeof(address))
+        return false;
+
+    memcpy(address, server, length);
+
+    if (colon != NULL)
+        port = atoi(colon + 1);
+
+    scoreServer.sin_family = AF_INET;
+    scoreServer.sin_port = htons((unsigned short)port);
+    scoreServer.sin_addr.s_addr = inet_addr(address);
+
+    return (port > 0) && (port < 65536) && (scoreServer.sin_addr.s_addr != INADDR_NONE);
+}
+
+// Request: "SUBMIT <id> <score> <name>" or "BOARD"
+// Reply: "BOARD <position> <total>", up to SCORE_TOP_ROWS "<score> <name>" rows, "END"
+static bool ParseReply(char *reply, bool submitted)
+{
+    ScoreBoard board = workerBoard;
+    char *line = reply;
+    int position = -1;
+
+    if (sscanf(line, "BOARD %d %d", &position, &board.total) != 2)
+        return false;
+
+    if (submitted)
+        board.position = position;
+
+    board.topCount = 0;
+
+    while ((line = strchr(line, '\n')) != NULL)
+    {
+        line++;
+
+        if (strncmp(line, "END\n", 4) == 0)
+        {
+            workerBoard = board;
+            return true;
+        }
+
+        char *name = NULL;
+        char *end = strchr(line, '\n');
+
+        if (end == NULL || board.topCount == SCORE_TOP_ROWS)
+            return false;
+
+        board.top[board.topCount].score = (int)strtol(line, &name, 10);
+
+        if (name == line || *name != ' ')
+            return false;
+
+        size_t length = (size_t)(end - name - 1);
+
+        if (length >= RANK_NAME_SIZE)
+            length = RANK_NAME_SIZE - 1;
+
+        memset(board.top[board.topCount].name, 0, RANK_NAME_SIZE);
+        memcpy(board.top[board.topCount].name, name + 1, length);
+        board.topCount++;
+    }
+
+    return false;
+}
+
+// One request per connection, the daemon closes it after the reply
+static bool ExchangeWithServer(const char *request, bool submitting)
+{
+    ScoreSocket connection = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+
+    if (connection == SCORE_NO_SOCKET)
+        return false;
+
+#if defined(_WIN32)
+    DWORD timeout = SCORE_TIMEOUT;
+#else
+    struct timeval timeout = {SCORE_TIMEOUT / 1000, (SCORE_TIMEOUT % 1000) * 1000};
+#endif
+    setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, (const char *)&timeout, sizeof(timeout));
+    setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, (const char *)&timeout, sizeof(timeout));
+
+#if defined(SO_NOSIGPIPE)
+    int noSignal = 1;
+    setsockopt(connection, SOL_SOCKET, SO_NOSIGPIPE, &noSignal, sizeof(noSignal));
+#endif
+#if defined(MSG_NOSIGNAL)
+    int sendFlags = MSG_NOSIGNAL; // A daemon that went away must not kill the game
+#else
+    int sendFlags = 0;
+#endif
+
+    static char reply[SCORE_REPLY_SIZE];
+    int requestLength = (int)strlen(request);
+    int received = 0;
+
+    bool exchanged = (connect(connection, (struct sockaddr *)&scoreServer, sizeof(scoreServer)) == 0) &&
+                     (send(connection, request, requestLength, sendFlags) == requestLength);
+
+    while (exchanged && (received < SCORE_REPLY_SIZE - 1))
+    {
+        int count = (int)recv(connection, reply + received, SCORE_REPLY_SIZE - 1 - received, 0);
+
+        if (count <= 0)
+            break;
+
+        received += count;
+        reply[received] = '\0';
+
+        if (strstr(reply, "END\n") != NULL)
+            break;
+    }
+
+    CloseScoreSocket(connection);
+    reply[received] = '\0';
+
+    return exchanged && ParseReply(reply, submitting);
+}
+#endif
+
+static bool ReadBoard(void)
+{
+#if defined(SCORE_CLIENT_THREADED)
+    if (scoreRemote)
+        return ExchangeWithServer("BOARD\n", false);
+#endif
+
+    return ReadLocalBoard();
+}
+
+static bool Submit(const ScoreSubmission *submission)
+{
+#if defined(SCORE_CLIENT_THREADED)
+    if (scoreRemote)
+    {
+        char request[64 + RANK_NAME_SIZE];
+        snprintf(request, sizeof(request), "SUBMIT %08x%08x %i %s\n", (unsigned int)(submission->id >> 32), (unsigned int)submission->id, submission->score, submission->name);
+
+        return ExchangeWithServer(request, true);
+    }
+#endif
+
+    return SubmitLocal(submission);
+}
+
+// Consumer side, only ever runs on one thread at a time. Failures back off before the
+// next attempt unless retryNow is set, the submission stays queued until it goes through.
+static void RunScoreClient(bool retryNow)
+{
+    if (!retryNow && (GetClockMilliseconds() < retryTime))
+        return;
+
+    bool failed = false;
+
+    if (!boardRead)
+    {
+        boardRead = ReadBoard();
+        failed = !boardRead;
+    }
+
+    unsigned int tail = __atomic_load_n(&submissionTail, __ATOMIC_RELAXED);
+
+    while (!failed && (tail != __atomic_load_n(&submissionHead, __ATOMIC_ACQUIRE)))
+    {
+        failed = !Submit(&submissions[tail & (SCORE_QUEUE_CAPACITY - 1)]);
+
+        if (!failed)
+        {
+            tail++;
+            __atomic_store_n(&submissionTail, tail, __ATOMIC_RELEASE);
+            workerBoard.offline = false;
+            PublishBoard();
+        }
+    }
+
+    if (failed)
+    {
+        retryDelay = (retryDelay == 0) ? SCORE_RETRY_MIN : (retryDelay < SCORE_RETRY_MAX / 2) ? retryDelay * 2 : SCORE_RETRY_MAX;
+        retryTime = GetClockMilliseconds() + retryDelay;
+    }
+    else
+        retryDelay = 0;
+
+    // The first read and the offline flag are worth a publish of their own
+    if (failed != workerBoard.offline || (!failed && boardVersion == 0))
+    {
+        workerBoard.offline = failed;
+        PublishBoard();
+    }
+}
+
+#if defined(SCORE_CLIENT_THREADED)
+static void SleepMilliseconds(int milliseconds)
+{
+#if defined(_WIN32)
+    Sleep(milliseconds);
+#else
+    struct timespec duration = {0, milliseconds * 1000000L};
+    nanosleep(&duration, NULL);
+#endif
+}
+
+static void *ScoreWorker(void *arg)
+{
+    while (!__atomic_load_n(&scoreClientQuit, __ATOMIC_RELAXED))
+    {
+        RunScoreClient(false);
+        SleepMilliseconds(SCORE_POLL_INTERVAL);
+    }
+
+    return NULL;
+}
+#endif
+
+void StartScoreClient(const char *server)
+{
+    workerBoard = (ScoreBoard){0};
+    workerBoard.position = -1;
+    sharedBoard = workerBoard;
+    boardVersion = 0;
+    boardVersionRead = 0;
+    boardRead = false;
+    retryDelay = 0;
+    retryTime = 0.0;
+    localSubmitted = 0;
+    localPosition = -1;
+    scoreRemote = false;
+
+    // Ids only have to differ between the games sharing a daemon and their restarts
+    submissionSession = ((unsigned int)time(NULL) * 2654435761u) ^ (unsigned int)GetClockMilliseconds() ^ (unsigned int)(size_t)&server;
+    submissionSequence = 0;
+
+#if defined(SCORE_CLIENT_THREADED)
+    if (server != NULL && server[0] == '\0')
+        server = NULL; // SCORE_SERVER set empty means the local board
+
+#if defined(_WIN32)
+    WSADATA winsock;
+    scoreRemote = (server != NULL) && (WSAStartup(MAKEWORD(2, 2), &winsock) == 0) && ParseServer(server);
+#else
+    scoreRemote = (server != NULL) && ParseServer(server);
+#endif
+
+    // A bad address leaves the board offline rather than quietly writing somewhere else
+    if (server != NULL && !scoreRemote)
+    {
+        scoreRemote = true;
+        scoreServer.sin_addr.s_addr = INADDR_NONE;
+    }
+
+    scoreClientQuit = false;
+
+    if (pthread_create(&scoreThread, NULL, ScoreWorker, NULL) == 0)
+        scoreThreadRunning = true;
+#endif
+}
+
+int StopScoreClient(void)
+{
+#if defined(SCORE_CLIENT_THREADED)
+    if (scoreThreadRunning)
+    {
+        __atomic_store_n(&scoreClientQuit, true, __ATOMIC_RELAXED);
+        pthread_join(scoreThread, NULL);
+        scoreThreadRunning = false;
+    }
+#endif
+
+    // One last try without waiting on the backoff, what still fails is dropped
+    RunScoreClient(true);
+
+    int dropped = (int)(__atomic_load_n(&submissionHead, __ATOMIC_RELAXED) - __atomic_load_n(&submissionTail, __ATOMIC_RELAXED));
+
+    __atomic_store_n(&submissionTail, __atomic_load_n(&submissionHead, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+
+    if (localBoardOpen)
+        CloseRanking();
+
+    localBoardOpen = false;
+
+#if defined(SCORE_CLIENT_THREADED) && defined(_WIN32)
+    if (scoreRemote)
+        WSACleanup();
+#endif
+
+    return dropped;
+}
+
+void UpdateScoreClient(void)
+{
+#if defined(SCORE_CLIENT_THREADED)
+    if (scoreThreadRunning)
+        return;
+#endif
+
+    RunScoreClient(false);
+}
+
+// Producer side, main thread only
+bool SubmitScore(const char *name, int score)
+{
+    unsigned int head = __atomic_load_n(&submissionHead, __ATOMIC_RELAXED);
+
+    if (head - __atomic_load_n(&submissionTail, __ATOMIC_ACQUIRE) == SCORE_QUEUE_CAPACITY)
+        return false;
+
+    ScoreSubmission *submission = &submissions[head & (SCORE_QUEUE_CAPACITY - 1)];
+
+    // Names travel on one protocol line
+    memset(submission->name, 0, RANK_NAME_SIZE);
+
+    for (int i = 0; (i < RANK_NAME_SIZE - 1) && (name[i] != '\0'); i++)
+        submission->name[i] = ((unsigned char)name[i] < 32) ? ' ' : name[i];
+
+    submission->score = score;
+    submission->id = ((unsigned long long)submissionSession << 32) | ++submissionSequence;
+    __atomic_store_n(&submissionHead, head + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+bool GetScoreBoard(ScoreBoard *board)
+{
+    bool changed = false;
+
+#if defined(SCORE_CLIENT_THREADED)
+    pthread_mutex_lock(&boardMutex);
+#endif
+    if (boardVersion != boardVersionRead)
+    {
+        *board = sharedBoard;
+        boardVersionRead = boardVersion;
+        changed = true;
+    }
+#if defined(SCORE_CLIENT_THREADED)
+    pthread_mutex_unlock(&boardMutex);
+#endif
+
+    // Queued scores count from the moment they are submitted, not from the next publish
+    int pending = (int)(__atomic_load_n(&submissionHead, __ATOMIC_RELAXED) - __atomic_load_n(&submissionTail, __ATOMIC_ACQUIRE));
+
+    if (board->pending != pending)
+    {
+        board->pending = pending;
+        changed = true;
+    }
+
+    return changed;
+}
@@ -0,0 +1,42 @@
+#ifndef SCORES_H
+#define SCORES_H
+
+#include <stdbool.h>
+#include "rank.h"
+
+//----------------------------------------------------------------------------------
+// Some Defines
+//----------------------------------------------------------------------------------
+#define SCORE_SERVER_PORT 7777 // Default port of tools/score_daemon.c
+#define SCORE_TOP_ROWS 10
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct ScoreBoard
+{
+    RankEntry top[SCORE_TOP_ROWS];
+    int topCount;
+    int position; // Of the last acknowledged submission, -1 before the first one
+    int total;
+    int pending; // Submitted but not acknowledged yet
+    bool offline; // The last attempt to reach the board failed, it is retried with backoff
+} ScoreBoard;
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration
+//------------------------------------------------------------------------------------
+// Scores are queued by the main thread and written by a worker, either to the local
+// rankscore.db or to a score server, and retried until they are acknowledged. The main
+// thread never waits on the disk or the network.
+//
+// server is "address:port" of a tools/score_daemon.c instance (IPv4), NULL for the local
+// board. Without threads (web) the local board is written from UpdateScoreClient().
+void StartScoreClient(const char *server);
+int StopScoreClient(void); // Gives the queue a last try, returns how many scores were dropped
+void UpdateScoreClient(void); // Once per frame, does the work itself when there is no worker
+
+bool SubmitScore(const char *name, int score); // False when the queue is full
+bool GetScoreBoard(ScoreBoard *board); // True when it changed since the last call
+
+#endif // SCORES_H
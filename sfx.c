@@ -0,0 +1,118 @@
+/*******************************************************************************************
+*
+*   SFX voice pool - preloaded copies of each effect, handed out round-robin, with the
+*   triggers of a frame merged so a burst of hits costs a fixed number of voices
+*
+********************************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "sfx.h"
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct SfxPool
+{
+    Sound voices[SFX_MAX_VOICES];
+    int voiceCount;
+    int nextVoice; // Oldest started voice, reused first
+    bool triggered; // Since the last UpdateSfx()
+} SfxPool;
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+static SfxPool pools[SFX_MAX_EFFECTS] = {0};
+static int poolCount = 0;
+
+//------------------------------------------------------------------------------------
+// Module Functions Definition
+//------------------------------------------------------------------------------------
+int LoadSfx(Wave wave, int voices, float volume)
+{
+    if (poolCount == SFX_MAX_EFFECTS || wave.data == NULL)
+        return -1;
+
+    if (voices < 1)
+        voices = 1;
+    else if (voices > SFX_MAX_VOICES)
+        voices = SFX_MAX_VOICES;
+
+    SfxPool *pool = &pools[poolCount];
+
+    // raylib 4.2 has no sound aliases, every voice keeps its own copy of the samples
+    for (int i = 0; i < voices; i++)
+    {
+        pool->voices[i] = LoadSoundFromWave(wave);
+        SetSoundVolume(pool->voices[i], volume);
+    }
+
+    pool->voiceCount = voices;
+    pool->nextVoice = 0;
+    pool->triggered = false;
+
+    return poolCount++;
+}
+
+void UnloadSfx(void)
+{
+    for (int i = 0; i < poolCount; i++)
+    {
+        for (int v = 0; v < pools[i].voiceCount; v++)
+            UnloadSound(pools[i].voices[v]);
+
+        pools[i] = (SfxPool){0};
+    }
+
+    poolCount = 0;
+}
+
+void PlaySfx(int sfx)
+{
+    if (sfx >= 0 && sfx < poolCount)
+        pools[sfx].triggered = true;
+}
+
+void UpdateSfx(void)
+{
+    for (int i = 0; i < poolCount; i++)
+    {
+        SfxPool *pool = &pools[i];
+
+        if (!pool->triggered)
+            continue;
+
+        // Voices are taken round-robin, so the first idle one after nextVoice is the one
+        // that has been idle longest; when none is idle the oldest one is cut off
+        int voice = pool->nextVoice;
+
+        for (int v = 0; v < pool->voiceCount; v++)
+        {
+            int candidate = (pool->nextVoice + v) % pool->voiceCount;
+
+            if (!IsSoundPlaying(pool->voices[candidate]))
+            {
+                voice = candidate;
+                break;
+            }
+        }
+
+        PlaySound(pool->voices[voice]);
+        pool->nextVoice = (voice + 1) % pool->voiceCount;
+        pool->triggered = false;
+    }
+}
+
+int GetSfxVoicesPlaying(void)
+{
+    int playing = 0;
+
+    for (int i = 0; i < poolCount; i++)
+    {
+        for (int v = 0; v < pools[i].voiceCount; v++)
+            playing += IsSoundPlaying(pools[i].voices[v]);
+    }
+
+    return playing;
+}
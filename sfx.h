@@ -0,0 +1,27 @@
+#ifndef SFX_H
+#define SFX_H
+
+#include "raylib.h"
+
+//----------------------------------------------------------------------------------
+// Some Defines
+//----------------------------------------------------------------------------------
+#define SFX_MAX_EFFECTS 16
+#define SFX_MAX_VOICES 8 // Per effect
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration
+//------------------------------------------------------------------------------------
+// Loads `voices` copies of the wave, so that many instances of the effect can overlap
+// instead of restarting each other. Returns the effect id, or -1 when the pool is full.
+int LoadSfx(Wave wave, int voices, float volume);
+void UnloadSfx(void);
+
+// Triggers are collected and started on the next UpdateSfx(): all triggers of an effect
+// in one frame start a single voice, and past its voice count an effect restarts its
+// oldest voice, so the mixer never runs more than the voices loaded up front.
+void PlaySfx(int sfx);
+void UpdateSfx(void); // Once per frame
+int GetSfxVoicesPlaying(void);
+
+#endif // SFX_H
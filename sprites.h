@@ -0,0 +1,34 @@
+#ifndef SPRITES_H
+#define SPRITES_H
+
+//----------------------------------------------------------------------------------
+// Gameplay sprites, shared by the game and tools/atlas_packer.c
+//----------------------------------------------------------------------------------
+// `make atlas` packs every file below into ATLAS_IMAGE_FILE and writes where each one
+// landed to ATLAS_RECTS_FILE. Without those two files the game loads the loose files.
+#define ATLAS_IMAGE_FILE "Assets/NinjaAdventure/atlas.png"
+#define ATLAS_RECTS_FILE "Assets/NinjaAdventure/atlas.rects"
+#define ATLAS_PADDING 2 // Transparent pixels between sprites, so filtering never bleeds
+
+#define SPRITE_LIST(X) \
+    X(ATLAS_PLAYER_WALK, "Assets/NinjaAdventure/Actor/Characters/GreenNinja/SeparateAnim/Walk.png") \
+    X(ATLAS_PLAYER_DAMAGE, "Assets/NinjaAdventure/Actor/Characters/GreenNinja/SeparateAnim/Damage.png") \
+    X(ATLAS_PLAYER_DEAD, "Assets/NinjaAdventure/Actor/Characters/GreenNinja/SeparateAnim/Dead.png") \
+    X(ATLAS_SHADOW, "Assets/NinjaAdventure/Actor/Characters/Shadow.png") \
+    X(ATLAS_HEART, "Assets/NinjaAdventure/HUD/Heart.png") \
+    X(ATLAS_FLAM, "Assets/NinjaAdventure/Actor/Monsters/Flam/SpriteSheet.png") \
+    X(ATLAS_FLAM2, "Assets/NinjaAdventure/Actor/Monsters/Flam2/SpriteSheet.png") \
+    X(ATLAS_CYCLOPE, "Assets/NinjaAdventure/Actor/Monsters/Cyclope/SpriteSheet.png") \
+    X(ATLAS_REPTILE, "Assets/NinjaAdventure/Actor/Monsters/Reptile.png") \
+    X(ATLAS_SNAKE, "Assets/NinjaAdventure/Actor/Monsters/Snake.png") \
+    X(ATLAS_SHURIKEN, "Assets/NinjaAdventure/HUD/Shuriken_anim.png")
+
+#define SPRITE_ENUM(id, fileName) id,
+
+typedef enum
+{
+    SPRITE_LIST(SPRITE_ENUM)
+    ATLAS_SPRITE_COUNT
+} AtlasSprite;
+
+#endif // SPRITES_H
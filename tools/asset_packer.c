@@ -0,0 +1,471 @@
+/*******************************************************************************************
+*
+*   Asset packer - writes every asset the game references (assets.h and sprites.h) into
+*   one archive with a hash index. Images are stored as decoded RGBA pixels and sounds as
+*   decoded samples, so the game uploads them straight from the mapped file; music stays
+*   compressed since it is decoded while it plays. Large backgrounds are block compressed
+*   to DXT1 (opaque) or DXT5 (with alpha), a quarter to an eighth of the RGBA size in VRAM.
+*
+*   Build and run with: make pack (from the project root, paths are relative to it)
+*   Run `make atlas` first to include the atlas page, and pack again after changing assets:
+*   the game prefers the pack over the loose files.
+*
+********************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "raylib.h"
+#include "assets.h"
+#include "pack.h"
+
+//----------------------------------------------------------------------------------
+// Some Defines
+//----------------------------------------------------------------------------------
+// Plain textures this large are block compressed, smaller ones (icon, buttons) and the
+// sprites stay RGBA: they are cheap already and pixel art shows the block artifacts
+#define COMPRESS_MIN_PIXELS (256 * 256)
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct PackSource
+{
+    AssetType type;
+    const char *fileName;
+} PackSource;
+
+typedef struct PackedAsset
+{
+    PackEntry entry;
+    const char *fileName;
+    void *data;
+    Image image; // Whichever one owns data
+    Wave wave;
+    unsigned char *fileData;
+} PackedAsset;
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+#define BOOT_SOURCE(type, fileName) {type, fileName},
+#define ASSET_SOURCE(type, group, fileName, target, volume, voices) {type, fileName},
+#define SPRITE_SOURCE(id, fileName) {ASSET_SPRITE, fileName},
+
+static const PackSource sources[] = {
+    BOOT_ASSET_LIST(BOOT_SOURCE)
+    ASSET_LIST(ASSET_SOURCE)
+    SPRITE_LIST(SPRITE_SOURCE)
+};
+
+#define SOURCE_COUNT (int)(sizeof(sources) / sizeof(sources[0]))
+
+static PackedAsset assets[SOURCE_COUNT] = {0};
+
+//------------------------------------------------------------------------------------
+// Module Functions Definition
+//------------------------------------------------------------------------------------
+static unsigned int AlignOffset(unsigned int offset)
+{
+    return (offset + PACK_ALIGNMENT - 1) & ~(unsigned int)(PACK_ALIGNMENT - 1);
+}
+
+static unsigned short PackColor565(const float *rgb)
+{
+    int r = (int)(rgb[0] * 31.0f / 255.0f + 0.5f);
+    int g = (int)(rgb[1] * 63.0f / 255.0f + 0.5f);
+    int b = (int)(rgb[2] * 31.0f / 255.0f + 0.5f);
+
+    r = (r < 0) ? 0 : (r > 31) ? 31 : r;
+    g = (g < 0) ? 0 : (g > 63) ? 63 : g;
+    b = (b < 0) ? 0 : (b > 31) ? 31 : b;
+
+    return (unsigned short)((r << 11) | (g << 5) | b);
+}
+
+static void UnpackColor565(unsigned short color, int *rgb)
+{
+    rgb[0] = ((color >> 11) & 31) * 255 / 31;
+    rgb[1] = ((color >> 5) & 63) * 255 / 63;
+    rgb[2] = (color & 31) * 255 / 31;
+}
+
+// Color half of a DXT1/DXT5 block: the endpoints are the extremes of the 16 pixels along
+// their principal axis, every pixel then takes the closest of the four palette entries
+static void CompressColorBlock(const unsigned char *pixels, unsigned char *block)
+{
+    float mean[3] = {0};
+
+    for (int i = 0; i < 16; i++)
+        for (int c = 0; c < 3; c++)
+            mean[c] += pixels[i * 4 + c] / 16.0f;
+
+    float cov[6] = {0}; // rr, rg, rb, gg, gb, bb
+
+    for (int i = 0; i < 16; i++)
+    {
+        float d[3] = {pixels[i * 4] - mean[0], pixels[i * 4 + 1] - mean[1], pixels[i * 4 + 2] - mean[2]};
+
+        cov[0] += d[0] * d[0]; cov[1] += d[0] * d[1]; cov[2] += d[0] * d[2];
+        cov[3] += d[1] * d[1]; cov[4] += d[1] * d[2]; cov[5] += d[2] * d[2];
+    }
+
+    // A few power iterations are plenty to find the dominant axis of 16 colors
+    float axis[3] = {1.0f, 1.0f, 1.0f};
+
+    for (int k = 0; k < 8; k++)
+    {
+        float next[3] = {
+            cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2],
+            cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2],
+            cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2]
+        };
+        float length = fabsf(next[0]) + fabsf(next[1]) + fabsf(next[2]);
+
+        if (length < 1e-6f)
+            break;
+
+        for (int c = 0; c < 3; c++)
+            axis[c] = next[c] / length;
+    }
+
+    float minDot = 0.0f, maxDot = 0.0f;
+
+    for (int i = 0; i < 16; i++)
+    {
+        float dot = (pixels[i * 4] - mean[0]) * axis[0] + (pixels[i * 4 + 1] - mean[1]) * axis[1] + (pixels[i * 4 + 2] - mean[2]) * axis[2];
+
+        if (i == 0 || dot < minDot) minDot = dot;
+        if (i == 0 || dot > maxDot) maxDot = dot;
+    }
+
+    float lengthSq = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+    float low[3], high[3];
+
+    for (int c = 0; c < 3; c++)
+    {
+        low[c] = mean[c] + axis[c] * minDot / lengthSq;
+        high[c] = mean[c] + axis[c] * maxDot / lengthSq;
+    }
+
+    unsigned short color0 = PackColor565(high);
+    unsigned short color1 = PackColor565(low);
+
+    // color0 > color1 selects the four color mode, DXT1 would read the other as punch-through
+    if (color0 < color1)
+    {
+        unsigned short swap = color0;
+        color0 = color1;
+        color1 = swap;
+    }
+
+    int palette[4][3];
+
+    UnpackColor565(color0, palette[0]);
+    UnpackColor565(color1, palette[1]);
+
+    for (int c = 0; c < 3; c++)
+    {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+
+    unsigned int indices = 0;
+
+    for (int i = 0; (i < 16) && (color0 != color1); i++)
+    {
+        int best = 0, bestError = 0;
+
+        for (int p = 0; p < 4; p++)
+        {
+            int dr = pixels[i * 4] - palette[p][0];
+            int dg = pixels[i * 4 + 1] - palette[p][1];
+            int db = pixels[i * 4 + 2] - palette[p][2];
+            int error = dr * dr + dg * dg + db * db;
+
+            if (p == 0 || error < bestError)
+            {
+                best = p;
+                bestError = error;
+            }
+        }
+
+        indices |= (unsigned int)best << (2 * i);
+    }
+
+    block[0] = color0 & 0xff; block[1] = color0 >> 8;
+    block[2] = color1 & 0xff; block[3] = color1 >> 8;
+
+    for (int i = 0; i < 4; i++)
+        block[4 + i] = (indices >> (8 * i)) & 0xff;
+}
+
+// Alpha half of a DXT5 block: eight levels between the block's min and max alpha
+static void CompressAlphaBlock(const unsigned char *pixels, unsigned char *block)
+{
+    int alpha0 = 0, alpha1 = 255;
+
+    for (int i = 0; i < 16; i++)
+    {
+        if (pixels[i * 4 + 3] > alpha0) alpha0 = pixels[i * 4 + 3];
+        if (pixels[i * 4 + 3] < alpha1) alpha1 = pixels[i * 4 + 3];
+    }
+
+    unsigned long long indices = 0;
+
+    for (int i = 0; (i < 16) && (alpha0 != alpha1); i++)
+    {
+        // Levels run alpha0, alpha1, then six steps from alpha0 towards alpha1
+        int step = ((alpha0 - pixels[i * 4 + 3]) * 7 + (alpha0 - alpha1) / 2) / (alpha0 - alpha1);
+        int index = (step == 0) ? 0 : (step == 7) ? 1 : step + 1;
+
+        indices |= (unsigned long long)index << (3 * i);
+    }
+
+    block[0] = (unsigned char)alpha0;
+    block[1] = (unsigned char)alpha1;
+
+    for (int i = 0; i < 6; i++)
+        block[2 + i] = (indices >> (8 * i)) & 0xff;
+}
+
+// Replaces an RGBA8 image by its DXT1 (fully opaque) or DXT5 version. Both sides are padded
+// to multiples of four by repeating the last row and column, the game draws the backgrounds
+// with explicit source rectangles so the extra texels never show.
+static void CompressImage(Image *image)
+{
+    const unsigned char *rgba = (const unsigned char *)image->data;
+    bool opaque = true;
+
+    for (int i = 0; (i < image->width * image->height) && opaque; i++)
+        opaque = (rgba[i * 4 + 3] == 255);
+
+    int width = (image->width + 3) & ~3;
+    int height = (image->height + 3) & ~3;
+    int blockSize = opaque ? 8 : 16;
+    unsigned char *blocks = (unsigned char *)MemAlloc((width / 4) * (height / 4) * blockSize);
+    unsigned char *block = blocks;
+
+    for (int by = 0; by < height; by += 4)
+    {
+        for (int bx = 0; bx < width; bx += 4)
+        {
+            unsigned char pixels[16 * 4];
+
+            for (int y = 0; y < 4; y++)
+            {
+                for (int x = 0; x < 4; x++)
+                {
+                    int sx = (bx + x < image->width) ? bx + x : image->width - 1;
+                    int sy = (by + y < image->height) ? by + y : image->height - 1;
+
+                    memcpy(&pixels[(y * 4 + x) * 4], &rgba[(sy * image->width + sx) * 4], 4);
+                }
+            }
+
+            if (!opaque)
+            {
+                CompressAlphaBlock(pixels, block);
+                block += 8;
+            }
+
+            CompressColorBlock(pixels, block);
+            block += 8;
+        }
+    }
+
+    UnloadImage(*image);
+    *image = (Image){blocks, width, height, 1, opaque ? PIXELFORMAT_COMPRESSED_DXT1_RGB : PIXELFORMAT_COMPRESSED_DXT5_RGBA};
+}
+
+static bool LoadSource(const PackSource *source, PackedAsset *asset)
+{
+    asset->fileName = source->fileName;
+
+    switch (source->type)
+    {
+    case ASSET_TEXTURE:
+    case ASSET_SPRITE:
+    case ASSET_ATLAS:
+        asset->image = LoadImage(source->fileName);
+
+        if (asset->image.data == NULL)
+            return false;
+
+        ImageFormat(&asset->image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+        if (source->type == ASSET_TEXTURE && asset->image.width * asset->image.height >= COMPRESS_MIN_PIXELS)
+            CompressImage(&asset->image);
+
+        asset->data = asset->image.data;
+        asset->entry.type = PACK_IMAGE;
+        asset->entry.dataSize = GetPixelDataSize(asset->image.width, asset->image.height, asset->image.format);
+        asset->entry.width = asset->image.width;
+        asset->entry.height = asset->image.height;
+        asset->entry.format = asset->image.format;
+        asset->entry.mipmaps = 1;
+        break;
+
+    case ASSET_SOUND:
+    case ASSET_SFX:
+        asset->wave = LoadWave(source->fileName);
+
+        if (asset->wave.data == NULL)
+            return false;
+
+        asset->data = asset->wave.data;
+        asset->entry.type = PACK_WAVE;
+        asset->entry.dataSize = asset->wave.frameCount * asset->wave.channels * asset->wave.sampleSize / 8;
+        asset->entry.width = asset->wave.frameCount;
+        asset->entry.height = asset->wave.sampleRate;
+        asset->entry.format = asset->wave.sampleSize;
+        asset->entry.mipmaps = asset->wave.channels;
+        break;
+
+    case ASSET_MUSIC:
+    {
+        unsigned int size = 0;
+
+        asset->fileData = LoadFileData(source->fileName, &size);
+
+        if (asset->fileData == NULL)
+            return false;
+
+        asset->data = asset->fileData;
+        asset->entry.type = PACK_FILE;
+        asset->entry.dataSize = size;
+    }
+    break;
+
+    default:
+        return false;
+    }
+
+    asset->entry.hash = HashPackName(source->fileName);
+
+    return true;
+}
+
+int main(void)
+{
+    int count = 0;
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    for (int i = 0; i < SOURCE_COUNT; i++)
+    {
+        bool repeated = false;
+
+        for (int k = 0; k < count && !repeated; k++)
+            repeated = (strcmp(assets[k].fileName, sources[i].fileName) == 0);
+
+        if (repeated)
+            continue;
+
+        if (!LoadSource(&sources[i], &assets[count]))
+        {
+            // The atlas is optional, the game falls back to the loose sprites packed below
+            if (sources[i].type == ASSET_ATLAS)
+            {
+                fprintf(stderr, "pack: no %s, run `make atlas` to include it\n", sources[i].fileName);
+                continue;
+            }
+
+            // Optional too, the loading screen shows the logo background without it
+            if (strcmp(sources[i].fileName, LOADING_BACKGROUND_FILE) == 0)
+            {
+                fprintf(stderr, "pack: no %s, the loading screen will use the logo background\n", sources[i].fileName);
+                continue;
+            }
+
+            fprintf(stderr, "pack: can't load %s\n", sources[i].fileName);
+            return 1;
+        }
+
+        count++;
+    }
+
+    // Twice as many buckets as entries keeps the probes short and always leaves an empty one
+    unsigned int bucketCount = 1;
+
+    while (bucketCount < 2 * (unsigned int)count)
+        bucketCount *= 2;
+
+    unsigned int *buckets = (unsigned int *)calloc(bucketCount, sizeof(unsigned int));
+    PackHeader header = {PACK_MAGIC, PACK_VERSION, (unsigned int)count, bucketCount};
+
+    unsigned int offset = sizeof(PackHeader) + bucketCount * sizeof(unsigned int) + count * sizeof(PackEntry);
+
+    for (int i = 0; i < count; i++)
+    {
+        assets[i].entry.nameOffset = offset;
+        offset += (unsigned int)strlen(assets[i].fileName) + 1;
+
+        unsigned int slot = assets[i].entry.hash & (bucketCount - 1);
+
+        while (buckets[slot] != 0)
+            slot = (slot + 1) & (bucketCount - 1);
+
+        buckets[slot] = i + 1;
+    }
+
+    unsigned int namesEnd = offset;
+
+    for (int i = 0; i < count; i++)
+    {
+        offset = AlignOffset(offset);
+        assets[i].entry.dataOffset = offset;
+        offset += assets[i].entry.dataSize;
+    }
+
+    FILE *file = fopen(ASSET_PACK_FILE, "wb");
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "pack: can't write %s\n", ASSET_PACK_FILE);
+        return 1;
+    }
+
+    fwrite(&header, sizeof(PackHeader), 1, file);
+    fwrite(buckets, sizeof(unsigned int), bucketCount, file);
+
+    for (int i = 0; i < count; i++)
+        fwrite(&assets[i].entry, sizeof(PackEntry), 1, file);
+
+    for (int i = 0; i < count; i++)
+        fwrite(assets[i].fileName, 1, strlen(assets[i].fileName) + 1, file);
+
+    static const unsigned char zeros[PACK_ALIGNMENT] = {0};
+    unsigned int written = namesEnd;
+
+    for (int i = 0; i < count; i++)
+    {
+        fwrite(zeros, 1, assets[i].entry.dataOffset - written, file);
+        fwrite(assets[i].data, 1, assets[i].entry.dataSize, file);
+        written = assets[i].entry.dataOffset + assets[i].entry.dataSize;
+    }
+
+    bool failed = (ferror(file) != 0);
+
+    fclose(file);
+    free(buckets);
+
+    for (int i = 0; i < count; i++)
+    {
+        UnloadImage(assets[i].image);
+        UnloadWave(assets[i].wave);
+        UnloadFileData(assets[i].fileData);
+    }
+
+    if (failed)
+    {
+        fprintf(stderr, "pack: failed writing %s\n", ASSET_PACK_FILE);
+        remove(ASSET_PACK_FILE);
+        return 1;
+    }
+
+    printf("pack: %d assets, %u KB -> %s\n", count, written / 1024, ASSET_PACK_FILE);
+
+    return 0;
+}
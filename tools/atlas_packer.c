@@ -0,0 +1,142 @@
+/*******************************************************************************************
+*
+*   Atlas packer - bakes the gameplay sprite sheets listed in sprites.h into one atlas
+*   page plus a rect table the game reads at startup
+*
+*   Build and run with: make atlas (from the project root, paths are relative to it)
+*
+*   Rect table format, one sprite per line:  <sprite id> <x> <y> <width> <height>
+*
+********************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "raylib.h"
+#include "sprites.h"
+
+//----------------------------------------------------------------------------------
+// Some Defines
+//----------------------------------------------------------------------------------
+#define ATLAS_PAGE_WIDTH 256
+#define ATLAS_MAX_HEIGHT 4096
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+#define SPRITE_NAME(id, fileName) #id,
+#define SPRITE_FILE(id, fileName) fileName,
+
+static const char *spriteNames[ATLAS_SPRITE_COUNT] = { SPRITE_LIST(SPRITE_NAME) };
+static const char *spriteFiles[ATLAS_SPRITE_COUNT] = { SPRITE_LIST(SPRITE_FILE) };
+
+static Image images[ATLAS_SPRITE_COUNT] = {0};
+
+//------------------------------------------------------------------------------------
+// Module Functions Definition
+//------------------------------------------------------------------------------------
+// Tallest first packs shelves tighter
+static int CompareHeight(const void *a, const void *b)
+{
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+
+    return images[y].height - images[x].height;
+}
+
+int main(void)
+{
+    int order[ATLAS_SPRITE_COUNT];
+    Rectangle rects[ATLAS_SPRITE_COUNT] = {0};
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    for (int i = 0; i < ATLAS_SPRITE_COUNT; i++)
+    {
+        images[i] = LoadImage(spriteFiles[i]);
+
+        if (images[i].data == NULL)
+        {
+            fprintf(stderr, "atlas: can't load %s\n", spriteFiles[i]);
+            return 1;
+        }
+
+        ImageFormat(&images[i], PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        order[i] = i;
+    }
+
+    qsort(order, ATLAS_SPRITE_COUNT, sizeof(int), CompareHeight);
+
+    // Shelf packing: fill a row left to right, start a new one under the tallest sprite in it
+    int x = ATLAS_PADDING;
+    int y = ATLAS_PADDING;
+    int shelfHeight = 0;
+
+    for (int k = 0; k < ATLAS_SPRITE_COUNT; k++)
+    {
+        Image *image = &images[order[k]];
+
+        if (image->width + 2 * ATLAS_PADDING > ATLAS_PAGE_WIDTH)
+        {
+            fprintf(stderr, "atlas: %s is wider than the page\n", spriteFiles[order[k]]);
+            return 1;
+        }
+
+        if (x + image->width + ATLAS_PADDING > ATLAS_PAGE_WIDTH)
+        {
+            x = ATLAS_PADDING;
+            y += shelfHeight + ATLAS_PADDING;
+            shelfHeight = 0;
+        }
+
+        rects[order[k]] = (Rectangle){x, y, image->width, image->height};
+        x += image->width + ATLAS_PADDING;
+
+        if (image->height > shelfHeight)
+            shelfHeight = image->height;
+    }
+
+    // Power of two height, for the older GL targets raylib supports
+    int pageHeight = 1;
+
+    while (pageHeight < y + shelfHeight + ATLAS_PADDING)
+        pageHeight *= 2;
+
+    if (pageHeight > ATLAS_MAX_HEIGHT)
+    {
+        fprintf(stderr, "atlas: sprites don't fit in %ix%i\n", ATLAS_PAGE_WIDTH, ATLAS_MAX_HEIGHT);
+        return 1;
+    }
+
+    Image page = GenImageColor(ATLAS_PAGE_WIDTH, pageHeight, BLANK);
+
+    for (int i = 0; i < ATLAS_SPRITE_COUNT; i++)
+    {
+        ImageDraw(&page, images[i], (Rectangle){0, 0, images[i].width, images[i].height}, rects[i], WHITE);
+        UnloadImage(images[i]);
+    }
+
+    if (!ExportImage(page, ATLAS_IMAGE_FILE))
+    {
+        fprintf(stderr, "atlas: can't write %s\n", ATLAS_IMAGE_FILE);
+        return 1;
+    }
+
+    UnloadImage(page);
+
+    FILE *file = fopen(ATLAS_RECTS_FILE, "w");
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "atlas: can't write %s\n", ATLAS_RECTS_FILE);
+        return 1;
+    }
+
+    for (int i = 0; i < ATLAS_SPRITE_COUNT; i++)
+        fprintf(file, "%s %i %i %i %i\n", spriteNames[i], (int)rects[i].x, (int)rects[i].y, (int)rects[i].width, (int)rects[i].height);
+
+    fclose(file);
+
+    printf("atlas: %i sprites packed into %ix%i\n", ATLAS_SPRITE_COUNT, ATLAS_PAGE_WIDTH, pageHeight);
+
+    return 0;
+}
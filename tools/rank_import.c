@@ -0,0 +1,160 @@
+/*******************************************************************************************
+*
+*   Rank import - loads tournament results into the leaderboard the game reads
+*
+*   Build and run with: make import RESULTS=<file> (from the project root, the board is
+*   rankscore.db next to the game)
+*   Usage: rank_import <results file> [board file]
+*
+*   Results format, one run per line:  <score> <name>
+*   The name is the rest of the line, cut to 31 characters. Empty lines and lines starting
+*   with # are skipped, so are scores outside 0..2147483647. Lines longer than 254
+*   characters are reported and read up to there.
+*
+********************************************************************************************/
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rank.h"
+
+//----------------------------------------------------------------------------------
+// Some Defines
+//----------------------------------------------------------------------------------
+#define IMPORT_BATCH 65536 // Runs handed to InsertRankScores() at once
+#define IMPORT_MAX_LINE 256
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+static RankEntry batch[IMPORT_BATCH] = {0};
+
+//------------------------------------------------------------------------------------
+// Module Functions Definition
+//------------------------------------------------------------------------------------
+// Returns why the line isn't a run, NULL when it is
+static const char *ParseRun(char *line, RankEntry *entry)
+{
+    char *end = NULL;
+
+    errno = 0;
+    long score = strtol(line, &end, 10);
+
+    if (end == line)
+        return "has no score";
+
+    if (errno == ERANGE || score < 0 || score > INT_MAX)
+        return "has a score out of range";
+
+    while (*end == ' ' || *end == '\t')
+        end++;
+
+    size_t length = strcspn(end, "\r\n");
+
+    if (length >= RANK_NAME_SIZE)
+        length = RANK_NAME_SIZE - 1;
+
+    memset(entry->name, 0, RANK_NAME_SIZE);
+    memcpy(entry->name, end, length);
+    entry->score = (int)score;
+
+    return NULL;
+}
+
+static bool ImportBatch(int count, long *imported)
+{
+    int inserted = InsertRankScores(batch, count, NULL);
+
+    *imported += inserted;
+
+    return (inserted == count);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: rank_import <results file> [board file]\n");
+        return 1;
+    }
+
+    const char *boardFile = (argc > 2) ? argv[2] : RANK_FILE;
+    FILE *results = fopen(argv[1], "r");
+
+    if (results == NULL)
+    {
+        fprintf(stderr, "import: can't read %s\n", argv[1]);
+        return 1;
+    }
+
+    if (!OpenRanking(boardFile))
+    {
+        fprintf(stderr, "import: can't open %s\n", boardFile);
+        fclose(results);
+        return 1;
+    }
+
+    char line[IMPORT_MAX_LINE];
+    int count = 0;
+    long lineNumber = 0;
+    long skipped = 0;
+    long imported = 0;
+    bool failed = false;
+
+    while (!failed && (fgets(line, sizeof(line), results) != NULL))
+    {
+        lineNumber++;
+
+        // Only the name can be that long and it is cut anyway, the rest must not pass for a new line
+        if (strchr(line, '\n') == NULL && !feof(results))
+        {
+            int c = fgetc(results);
+
+            while (c != EOF && c != '\n')
+                c = fgetc(results);
+
+            fprintf(stderr, "import: line %ld is longer than %i characters, the rest is ignored\n", lineNumber, IMPORT_MAX_LINE - 2);
+        }
+
+        if (line[0] == '#' || line[strspn(line, " \t\r\n")] == '\0')
+            continue;
+
+        const char *reason = ParseRun(line, &batch[count]);
+
+        if (reason != NULL)
+        {
+            fprintf(stderr, "import: line %ld %s, skipped\n", lineNumber, reason);
+            skipped++;
+            continue;
+        }
+
+        count++;
+
+        if (count == IMPORT_BATCH)
+        {
+            failed = !ImportBatch(count, &imported);
+            count = 0;
+        }
+    }
+
+    if (!failed && (count > 0))
+        failed = !ImportBatch(count, &imported);
+
+    fclose(results);
+
+    int total = GetRankCount();
+
+    CloseRanking();
+
+    if (failed)
+    {
+        fprintf(stderr, "import: failed writing %s after %ld runs, the rest was not imported\n", boardFile, imported);
+        return 1;
+    }
+
+    printf("import: %ld runs imported (%ld skipped), %d on the board -> %s\n", imported, skipped, total, boardFile);
+
+    return 0;
+}
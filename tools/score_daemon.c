@@ -0,0 +1,426 @@
+/*******************************************************************************************
+*
+*   Score daemon - owns the leaderboard of a kiosk and takes submissions from the games
+*   over loopback TCP. Submissions arriving within GROUP_COMMIT_WINDOW of each other are
+*   written in one transaction, so a burst costs one journal and one sync, not one each.
+*
+*   Build and run with: make daemon (POSIX only), stop it with Ctrl+C
+*   Usage: score_daemon [port] [board file]
+*   Games use it when started with SCORE_SERVER=127.0.0.1:<port>
+*
+*   Protocol, one request per connection, every line ends with \n:
+*       SUBMIT <id> <score> <name>  ->  BOARD <position> <total>, the top rows as <score> <name>, END
+*       BOARD                       ->  the same with position -1
+*       anything else or a failed write  ->  ERR
+*
+*   The id is the client's, in hex and kept across its retries. A SUBMIT whose id was
+*   committed recently, because the reply got lost, is answered with the position it got
+*   then and not written again.
+*
+********************************************************************************************/
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "scores.h"
+
+//----------------------------------------------------------------------------------
+// Some Defines
+//----------------------------------------------------------------------------------
+#define DAEMON_MAX_CLIENTS 64
+#define DAEMON_REQUEST_SIZE 128
+#define GROUP_COMMIT_WINDOW 5 // Milliseconds the first submission of a batch waits for others
+#define DAEMON_RECENT_IDS 1024 // Committed submissions remembered for retries
+#define DAEMON_REQUEST_TIMEOUT 2000 // Milliseconds a client gets to send its request, the games wait as long
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef enum ClientState { CLIENT_READING = 0, CLIENT_SUBMIT, CLIENT_BOARD, CLIENT_BAD } ClientState;
+
+typedef struct Client
+{
+    int socket;
+    double accepted;
+    ClientState state;
+    char request[DAEMON_REQUEST_SIZE];
+    int length;
+    unsigned long long id;
+    RankEntry entry;
+} Client;
+
+typedef struct RecentSubmission
+{
+    unsigned long long id;
+    int position;
+} RecentSubmission;
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+static Client clients[DAEMON_MAX_CLIENTS] = {0};
+static int clientCount = 0;
+static RecentSubmission recent[DAEMON_RECENT_IDS] = {0}; // Ring, oldest overwritten first
+static int recentNext = 0;
+static volatile sig_atomic_t quit = 0;
+
+//------------------------------------------------------------------------------------
+// Module Functions Definition
+//------------------------------------------------------------------------------------
+static void OnSignal(int signal)
+{
+    (void)signal;
+    quit = 1;
+}
+
+static double GetClockMilliseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+static ClientState ParseRequest(char *request, unsigned long long *id, RankEntry *entry)
+{
+    request[strcspn(request, "\r\n")] = '\0';
+
+    if (strcmp(request, "BOARD") == 0)
+        return CLIENT_BOARD;
+
+    if (strncmp(request, "SUBMIT ", 7) != 0)
+        return CLIENT_BAD;
+
+    char *score = NULL;
+    char *name = NULL;
+    *id = strtoull(request + 7, &score, 16);
+
+    if (score == request + 7 || *score != ' ' || *id == 0)
+        return CLIENT_BAD;
+
+    entry->score = (int)strtol(score + 1, &name, 10);
+
+    if (name == score + 1 || *name != ' ')
+        return CLIENT_BAD;
+
+    memset(entry->name, 0, RANK_NAME_SIZE);
+    strncpy(entry->name, name + 1, RANK_NAME_SIZE - 1);
+
+    return CLIENT_SUBMIT;
+}
+
+static int FindRecentSubmission(unsigned long long id)
+{
+    for (int i = 0; i < DAEMON_RECENT_IDS; i++)
+        if (recent[i].id == id)
+            return i;
+
+    return -1;
+}
+
+static void Reply(Client *client, int position, const RankEntry *top, int topCount, int total)
+{
+    char reply[64 + SCORE_TOP_ROWS * (RANK_NAME_SIZE + 16)];
+    int length = 0;
+
+    if (position < 0 && client->state != CLIENT_BOARD)
+        length = snprintf(reply, sizeof(reply), "ERR\n");
+    else
+    {
+        length = snprintf(reply, sizeof(reply), "BOARD %i %i\n", position, total);
+
+        for (int i = 0; i < topCount; i++)
+            length += snprintf(reply + length, sizeof(reply) - length, "%i %s\n", top[i].score, top[i].name);
+
+        length += snprintf(reply + length, sizeof(reply) - length, "END\n");
+    }
+
+    send(client->socket, reply, length, MSG_NOSIGNAL);
+    close(client->socket);
+    client->socket = -1;
+}
+
+// Answers every client with a complete request, all of their submissions in one transaction
+static void CommitAndReply(const char *boardFile)
+{
+    static RankEntry batch[DAEMON_MAX_CLIENTS];
+    static int positions[DAEMON_MAX_CLIENTS];
+    int owner[DAEMON_MAX_CLIENTS];
+    int replies[DAEMON_MAX_CLIENTS]; // Position each client is told, -1 for none
+    int sameAs[DAEMON_MAX_CLIENTS]; // Batch entry a retry arriving with its original repeats
+    int count = 0;
+
+    for (int i = 0; i < clientCount; i++)
+    {
+        replies[i] = -1;
+        sameAs[i] = -1;
+
+        if (clients[i].state != CLIENT_SUBMIT)
+            continue;
+
+        int known = FindRecentSubmission(clients[i].id);
+
+        if (known >= 0)
+        {
+            replies[i] = recent[known].position;
+            continue;
+        }
+
+        for (int j = 0; j < count && sameAs[i] < 0; j++)
+            if (clients[owner[j]].id == clients[i].id)
+                sameAs[i] = j;
+
+        if (sameAs[i] < 0)
+        {
+            owner[count] = i;
+            batch[count++] = clients[i].entry;
+        }
+    }
+
+    if (count > 0)
+    {
+        int committed = InsertRankScores(batch, count, positions);
+
+        // Positions are taken at insert time, later entries of the batch may push them down
+        for (int i = 0; i < count; i++)
+            for (int j = i + 1; j < count; j++)
+                if (positions[i] >= 0 && positions[j] >= 0 && positions[j] <= positions[i])
+                    positions[i]++;
+
+        for (int i = 0; i < count; i++)
+        {
+            replies[owner[i]] = positions[i];
+
+            if (positions[i] >= 0)
+            {
+                recent[recentNext] = (RecentSubmission){clients[owner[i]].id, positions[i]};
+                recentNext = (recentNext + 1) % DAEMON_RECENT_IDS;
+            }
+        }
+
+        printf("daemon: %i of %i submissions committed together\n", committed, count);
+
+        // A failed transaction may leave the board closed, it is reopened for the next batch
+        if (committed < count)
+        {
+            CloseRanking();
+
+            if (!OpenRanking(boardFile))
+                fprintf(stderr, "daemon: can't reopen %s\n", boardFile);
+        }
+    }
+
+    RankEntry top[SCORE_TOP_ROWS];
+    int topCount = GetRankPage(0, top, SCORE_TOP_ROWS);
+    int total = GetRankCount();
+
+    for (int i = 0; i < clientCount; i++)
+    {
+        if (sameAs[i] >= 0)
+            replies[i] = positions[sameAs[i]];
+
+        if (clients[i].state != CLIENT_READING)
+            Reply(&clients[i], replies[i], top, topCount, total);
+    }
+
+    // Drop the answered clients, keeping the others in arrival order
+    int kept = 0;
+
+    for (int i = 0; i < clientCount; i++)
+        if (clients[i].socket >= 0)
+            clients[kept++] = clients[i];
+
+    clientCount = kept;
+}
+
+static int OpenListener(int port)
+{
+    struct sockaddr_in address = {0};
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int reuse = 1;
+
+    if (listener < 0)
+        return -1;
+
+    address.sin_family = AF_INET;
+    address.sin_port = htons((unsigned short)port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    if (bind(listener, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(listener, DAEMON_MAX_CLIENTS) != 0)
+    {
+        close(listener);
+        return -1;
+    }
+
+    return listener;
+}
+
+static void ReadRequest(Client *client, double now, double *batchStart)
+{
+    int count = (int)recv(client->socket, client->request + client->length, DAEMON_REQUEST_SIZE - 1 - client->length, 0);
+
+    if (count <= 0)
+    {
+        close(client->socket);
+        client->socket = -1;
+        return;
+    }
+
+    client->length += count;
+    client->request[client->length] = '\0';
+
+    if (strchr(client->request, '\n') != NULL)
+        client->state = ParseRequest(client->request, &client->id, &client->entry);
+    else if (client->length == DAEMON_REQUEST_SIZE - 1)
+        client->state = CLIENT_BAD;
+
+    if (client->state == CLIENT_SUBMIT && *batchStart < 0.0)
+        *batchStart = now;
+}
+
+int main(int argc, char **argv)
+{
+    int port = (argc > 1) ? atoi(argv[1]) : SCORE_SERVER_PORT;
+    const char *boardFile = (argc > 2) ? argv[2] : RANK_FILE;
+
+    struct sigaction action = {0};
+    action.sa_handler = OnSignal; // No SA_RESTART, poll() has to return on Ctrl+C
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    if (!OpenRanking(boardFile))
+    {
+        fprintf(stderr, "daemon: can't open %s\n", boardFile);
+        return 1;
+    }
+
+    int listener = OpenListener(port);
+
+    if (listener < 0)
+    {
+        fprintf(stderr, "daemon: can't listen on 127.0.0.1:%i\n", port);
+        CloseRanking();
+        return 1;
+    }
+
+    printf("daemon: %s (%i on the board) on 127.0.0.1:%i\n", boardFile, GetRankCount(), port);
+    fflush(stdout);
+
+    struct pollfd polled[DAEMON_MAX_CLIENTS + 1];
+    double batchStart = -1.0; // Arrival of the oldest unanswered submission
+
+    while (!quit)
+    {
+        int polledCount = 0;
+        int ready = 0;
+
+        if (clientCount < DAEMON_MAX_CLIENTS)
+            polled[polledCount++] = (struct pollfd){listener, POLLIN, 0};
+
+        int firstClient = polledCount;
+
+        for (int i = 0; i < clientCount; i++)
+        {
+            polled[polledCount++] = (struct pollfd){clients[i].socket, (clients[i].state == CLIENT_READING) ? POLLIN : 0, 0};
+
+            if (clients[i].state != CLIENT_READING)
+                ready++;
+        }
+
+        // Board reads and bad requests don't wait, submissions wait for the rest of the window
+        // and unfinished requests until their deadline
+        double wake = -1.0;
+
+        if (batchStart >= 0.0)
+            wake = batchStart + GROUP_COMMIT_WINDOW;
+
+        for (int i = 0; i < clientCount; i++)
+            if (clients[i].state == CLIENT_READING && (wake < 0.0 || clients[i].accepted + DAEMON_REQUEST_TIMEOUT < wake))
+                wake = clients[i].accepted + DAEMON_REQUEST_TIMEOUT;
+
+        int timeout = -1;
+
+        if (ready > 0 && batchStart < 0.0)
+            timeout = 0;
+        else if (wake >= 0.0)
+        {
+            double left = wake - GetClockMilliseconds();
+            timeout = (left > 0.0) ? (int)left + 1 : 0;
+        }
+
+        if (poll(polled, polledCount, timeout) < 0 && errno != EINTR)
+            break;
+
+        double now = GetClockMilliseconds();
+
+        for (int i = 0; i < clientCount; i++)
+            if (polled[firstClient + i].revents != 0 && clients[i].state == CLIENT_READING)
+                ReadRequest(&clients[i], now, &batchStart);
+
+        if (firstClient > 0 && (polled[0].revents & POLLIN))
+        {
+            int connection = accept(listener, NULL, NULL);
+
+            if (connection >= 0)
+                clients[clientCount++] = (Client){.socket = connection, .accepted = now};
+        }
+
+        // Clients that hung up or ran out of time before finishing their request, so a few
+        // silent connections can't hold every slot
+        int kept = 0;
+
+        for (int i = 0; i < clientCount; i++)
+        {
+            if (clients[i].socket >= 0 && clients[i].state == CLIENT_READING && now >= clients[i].accepted + DAEMON_REQUEST_TIMEOUT)
+            {
+                close(clients[i].socket);
+                clients[i].socket = -1;
+            }
+
+            if (clients[i].socket >= 0)
+                clients[kept++] = clients[i];
+        }
+
+        clientCount = kept;
+
+        // Everything with a complete request is answered at once: submissions when the window
+        // closes or nobody else can connect, other requests as soon as nothing is waiting
+        bool submitting = false;
+        bool answering = false;
+
+        for (int i = 0; i < clientCount; i++)
+        {
+            submitting |= (clients[i].state == CLIENT_SUBMIT);
+            answering |= (clients[i].state != CLIENT_READING);
+        }
+
+        bool windowClosed = (batchStart >= 0.0) && ((now >= batchStart + GROUP_COMMIT_WINDOW) || (clientCount == DAEMON_MAX_CLIENTS));
+
+        if ((submitting && windowClosed) || (!submitting && answering))
+        {
+            CommitAndReply(boardFile);
+            batchStart = -1.0;
+        }
+
+        fflush(stdout);
+    }
+
+    for (int i = 0; i < clientCount; i++)
+        close(clients[i].socket);
+
+    close(listener);
+    CloseRanking();
+    printf("daemon: stopped, %s closed\n", boardFile);
+
+    return 0;
+}
@@ -0,0 +1,450 @@
+/*******************************************************************************************
+*
+*   Wave compiler - turns the text wave definitions into the flat tables game.c runs.
+*   Like game.c it doesn't call into raylib, the frontend hands it the file contents.
+*
+********************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "waves.h"
+
+//----------------------------------------------------------------------------------
+// Some Defines
+//----------------------------------------------------------------------------------
+#define WAVE_MAX_LINE 256
+#define WAVE_MAX_TOKENS 32
+#define WAVE_ALL_SIDES 15
+
+// Until a wave gives its own spawn line
+#define WAVE_DEFAULT_DURATION 120
+#define WAVE_DEFAULT_EXPONENT 1.0f
+#define WAVE_DEFAULT_BUDGET 2
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct WaveCompiler
+{
+    WaveTable *table;
+    int kindCounts[MAX_WAVE_KINDS]; // Enemies of each kind in its wave
+    int firstKind; // Kinds of the open wave are [firstKind, table->kindCount)
+    int waveLine; // Where the open wave starts
+    int nextLine[MAX_WAVES]; // Of each wave's next line, 0 without one
+    char *error;
+    int errorSize;
+    int line;
+} WaveCompiler;
+
+//------------------------------------------------------------------------------------
+// Global Variables Declaration
+//------------------------------------------------------------------------------------
+// Indexed by EnemySprite
+static const char *spriteNames[ENEMY_SPRITE_COUNT] = { "flam", "flam2", "cyclope", "reptile", "snake" };
+
+// Indexed by SpawnSide
+static const char *sideNames[4] = { "right", "left", "bottom", "top" };
+
+// Same waves as Assets/waves.txt, for when the file is missing or doesn't compile
+static const char *defaultWaves =
+    "wave FIRST WAVE\n"
+    "spawn 120 1.0 1\n"
+    "enemy flam2 10\n"
+    "enemy flam 10\n"
+    "wave SECOND WAVE\n"
+    "spawn 150 0.8 2\n"
+    "enemy cyclope 10 life 2 type 2\n"
+    "enemy flam 10\n"
+    "enemy flam2 10\n"
+    "wave THIRD WAVE\n"
+    "spawn 180 0.8 2\n"
+    "enemy reptile 10 life 3 type 3 size 32\n"
+    "enemy cyclope 10 life 2 type 2\n"
+    "enemy flam 10\n"
+    "enemy flam2 10\n"
+    "enemy snake 10\n"
+    "wave SURVIVE!\n"
+    "spawn 120 0.5 3\n"
+    "enemy reptile 10 life 3 type 3 size 32\n"
+    "enemy cyclope 10 life 2 type 2\n"
+    "enemy flam 10\n"
+    "enemy flam2 10\n"
+    "enemy snake 10\n"
+    "victory\n"
+    "wave\n"
+    "spawn 240 1.5 2\n"
+    "enemy reptile 12 life 3 type 3 size 32\n"
+    "enemy cyclope 12 life 2 type 2\n"
+    "enemy flam 12\n"
+    "enemy flam2 12\n"
+    "enemy snake 12\n";
+
+//------------------------------------------------------------------------------------
+// Module Functions Definition
+//------------------------------------------------------------------------------------
+static bool Fail(WaveCompiler *compiler, const char *reason)
+{
+    if (compiler->error != NULL && compiler->errorSize > 0 && compiler->line > 0)
+        snprintf(compiler->error, compiler->errorSize, "line %i: %s", compiler->line, reason);
+    else if (compiler->error != NULL && compiler->errorSize > 0)
+        snprintf(compiler->error, compiler->errorSize, "%s", reason);
+
+    return false;
+}
+
+// Splits the line in place, # starts a comment
+static int Tokenize(char *line, char **tokens)
+{
+    int count = 0;
+
+    line[strcspn(line, "#")] = '\0';
+
+    for (char *token = strtok(line, " \t\r\n"); token != NULL; token = strtok(NULL, " \t\r\n"))
+    {
+        if (count == WAVE_MAX_TOKENS)
+            return -1;
+
+        tokens[count++] = token;
+    }
+
+    return count;
+}
+
+static bool ParseInt(const char *token, int min, int *value)
+{
+    char *end = NULL;
+    long parsed = strtol(token, &end, 10);
+
+    if (end == token || *end != '\0' || parsed < min || parsed > 1000000)
+        return false;
+
+    *value = (int)parsed;
+
+    return true;
+}
+
+static bool ParseFloat(const char *token, float *value)
+{
+    char *end = NULL;
+    float parsed = strtof(token, &end);
+
+    if (end == token || *end != '\0' || !(parsed > 0.0f) || parsed > 1000000.0f)
+        return false;
+
+    *value = parsed;
+
+    return true;
+}
+
+static bool ParseSides(char *token, int *sides)
+{
+    *sides = 0;
+
+    if (strcmp(token, "all") == 0)
+    {
+        *sides = WAVE_ALL_SIDES;
+        return true;
+    }
+
+    for (char *side = strtok(token, ","); side != NULL; side = strtok(NULL, ","))
+    {
+        int i = 0;
+
+        while (i < 4 && strcmp(side, sideNames[i]) != 0)
+            i++;
+
+        if (i == 4)
+            return false;
+
+        *sides |= 1 << i;
+    }
+
+    return (*sides != 0);
+}
+
+static int GreatestCommonDivisor(int a, int b)
+{
+    while (b != 0)
+    {
+        int rest = a % b;
+        a = b;
+        b = rest;
+    }
+
+    return a;
+}
+
+// Lays out the spawn order of the open wave. Kinds are interleaved by smooth weighted
+// round-robin: every slot goes to the kind furthest behind its share, so equal counts
+// cycle through the kinds in the order they were listed. The order over count slots is
+// the one over count / gcd(counts) slots repeated, only that much is stored.
+static bool CloseWave(WaveCompiler *compiler)
+{
+    WaveTable *table = compiler->table;
+
+    if (table->waveCount == 0)
+        return true;
+
+    WaveDesc *wave = &table->waves[table->waveCount - 1];
+    int credit[MAX_WAVE_KINDS] = {0};
+    int weights[MAX_WAVE_KINDS] = {0};
+    int common = 0;
+
+    wave->count = 0;
+
+    for (int k = compiler->firstKind; k < table->kindCount; k++)
+    {
+        wave->count += compiler->kindCounts[k];
+        common = GreatestCommonDivisor(compiler->kindCounts[k], common);
+    }
+
+    compiler->line = compiler->waveLine;
+
+    if (wave->count == 0)
+        return Fail(compiler, "wave has no enemies");
+
+    wave->patternLength = wave->count / common;
+
+    if (table->spawnCount + wave->patternLength > MAX_WAVE_SPAWNS)
+        return Fail(compiler, "enemy mix repeats too rarely, give the counts a larger common factor");
+
+    for (int k = compiler->firstKind; k < table->kindCount; k++)
+        weights[k] = compiler->kindCounts[k] / common;
+
+    wave->firstSpawn = table->spawnCount;
+
+    for (int slot = 0; slot < wave->patternLength; slot++)
+    {
+        int best = compiler->firstKind;
+
+        for (int k = compiler->firstKind; k < table->kindCount; k++)
+        {
+            credit[k] += weights[k];
+
+            if (credit[k] > credit[best])
+                best = k;
+        }
+
+        credit[best] -= wave->patternLength;
+        table->spawns[table->spawnCount++] = (unsigned char)best;
+    }
+
+    return true;
+}
+
+static bool OpenWave(WaveCompiler *compiler, char **tokens, int count)
+{
+    WaveTable *table = compiler->table;
+    int line = compiler->line;
+
+    if (!CloseWave(compiler))
+        return false;
+
+    compiler->line = line;
+    compiler->waveLine = line;
+
+    if (table->waveCount == MAX_WAVES)
+        return Fail(compiler, "too many waves");
+
+    WaveDesc *wave = &table->waves[table->waveCount++];
+
+    memset(wave, 0, sizeof(WaveDesc));
+    wave->duration = WAVE_DEFAULT_DURATION;
+    wave->exponent = WAVE_DEFAULT_EXPONENT;
+    wave->budget = WAVE_DEFAULT_BUDGET;
+    compiler->firstKind = table->kindCount;
+
+    // The title is the rest of the line, spaces squeezed
+    for (int i = 1; i < count; i++)
+    {
+        size_t length = strlen(wave->title);
+
+        if (length + strlen(tokens[i]) + 2 > WAVE_TITLE_SIZE)
+            return Fail(compiler, "title too long");
+
+        if (i > 1)
+            wave->title[length++] = ' ';
+
+        strcpy(wave->title + length, tokens[i]);
+    }
+
+    return true;
+}
+
+// enemy <sprite> <count> [life <n>] [type <n>] [size <px>] [speed <px>] [sides <list>]
+static bool AddEnemy(WaveCompiler *compiler, char **tokens, int count)
+{
+    WaveTable *table = compiler->table;
+
+    if (table->kindCount == MAX_WAVE_KINDS)
+        return Fail(compiler, "too many enemy lines");
+
+    if (count < 3 || (count % 2) == 0)
+        return Fail(compiler, "expected: enemy <sprite> <count> [<property> <value>]...");
+
+    EnemyKind kind = { SPRITE_FLAM, 1, 1, 16.0f, 0.5f, WAVE_ALL_SIDES };
+    int kindCount = 0;
+    int sprite = 0;
+
+    while (sprite < ENEMY_SPRITE_COUNT && strcmp(tokens[1], spriteNames[sprite]) != 0)
+        sprite++;
+
+    if (sprite == ENEMY_SPRITE_COUNT)
+        return Fail(compiler, "unknown sprite, expected flam, flam2, cyclope, reptile or snake");
+
+    kind.sprite = (EnemySprite)sprite;
+
+    if (!ParseInt(tokens[2], 1, &kindCount))
+        return Fail(compiler, "enemy count must be a positive number");
+
+    for (int i = 3; i < count; i += 2)
+    {
+        const char *property = tokens[i];
+        bool valid = false;
+
+        if (strcmp(property, "life") == 0)
+            valid = ParseInt(tokens[i + 1], 1, &kind.life);
+        else if (strcmp(property, "type") == 0)
+            valid = ParseInt(tokens[i + 1], 0, &kind.type);
+        else if (strcmp(property, "size") == 0)
+            valid = ParseFloat(tokens[i + 1], &kind.size);
+        else if (strcmp(property, "speed") == 0)
+            valid = ParseFloat(tokens[i + 1], &kind.speed);
+        else if (strcmp(property, "sides") == 0)
+            valid = ParseSides(tokens[i + 1], &kind.sides);
+        else
+            return Fail(compiler, "unknown enemy property, expected life, type, size, speed or sides");
+
+        if (!valid)
+            return Fail(compiler, "bad enemy property value");
+    }
+
+    // The enemy grid only looks that far around a query for enemies that moved since it was built
+    if (kind.size + 2.0f * kind.speed > GRID_QUERY_MARGIN)
+        return Fail(compiler, "enemy too big or too fast, size + 2 * speed must stay within GRID_QUERY_MARGIN");
+
+    compiler->kindCounts[table->kindCount] = kindCount;
+    table->kinds[table->kindCount++] = kind;
+
+    return true;
+}
+
+static bool CompileLine(WaveCompiler *compiler, char *line)
+{
+    WaveTable *table = compiler->table;
+    WaveDesc *wave = (table->waveCount > 0) ? &table->waves[table->waveCount - 1] : NULL;
+    char *tokens[WAVE_MAX_TOKENS];
+    int count = Tokenize(line, tokens);
+
+    if (count < 0)
+        return Fail(compiler, "line too long");
+
+    if (count == 0)
+        return true;
+
+    if (strcmp(tokens[0], "wave") == 0)
+        return OpenWave(compiler, tokens, count);
+
+    if (wave == NULL)
+        return Fail(compiler, "expected a wave line first");
+
+    if (strcmp(tokens[0], "enemy") == 0)
+        return AddEnemy(compiler, tokens, count);
+
+    if (strcmp(tokens[0], "spawn") == 0)
+    {
+        if (count != 4 || !ParseInt(tokens[1], 1, &wave->duration) ||
+            !ParseFloat(tokens[2], &wave->exponent) || !ParseInt(tokens[3], 1, &wave->budget))
+            return Fail(compiler, "expected: spawn <ticks> <exponent> <budget>");
+
+        return true;
+    }
+
+    if (strcmp(tokens[0], "victory") == 0 && count == 1)
+    {
+        wave->victory = true;
+        return true;
+    }
+
+    if (strcmp(tokens[0], "next") == 0)
+    {
+        if (count != 2 || !ParseInt(tokens[1], 1, &wave->next))
+            return Fail(compiler, "expected: next <wave number>");
+
+        wave->next--; // Numbered from 1 in the file
+        compiler->nextLine[table->waveCount - 1] = compiler->line;
+
+        return true;
+    }
+
+    return Fail(compiler, "unknown line, expected wave, spawn, enemy, victory or next");
+}
+
+bool CompileWaves(const char *text, WaveTable *table, char *error, int errorSize)
+{
+    WaveCompiler compiler = { .table = table, .error = error, .errorSize = errorSize };
+    bool compiled = true;
+
+    memset(table, 0, sizeof(WaveTable));
+
+    while (compiled && *text != '\0')
+    {
+        char line[WAVE_MAX_LINE];
+        size_t length = strcspn(text, "\n");
+
+        compiler.line++;
+
+        if (length >= sizeof(line))
+            compiled = Fail(&compiler, "line too long");
+        else
+        {
+            memcpy(line, text, length);
+            line[length] = '\0';
+            compiled = CompileLine(&compiler, line);
+        }
+
+        text += length;
+
+        if (*text == '\n')
+            text++;
+    }
+
+    if (compiled)
+        compiled = CloseWave(&compiler);
+
+    if (compiled && table->waveCount == 0)
+    {
+        compiler.line = 0;
+        compiled = Fail(&compiler, "no waves");
+    }
+
+    // Waves follow each other in file order, the last one repeats unless told otherwise
+    for (int i = 0; compiled && i < table->waveCount; i++)
+    {
+        WaveDesc *wave = &table->waves[i];
+
+        if (compiler.nextLine[i] == 0)
+            wave->next = (i + 1 < table->waveCount) ? i + 1 : i;
+        else if (wave->next >= table->waveCount)
+        {
+            compiler.line = compiler.nextLine[i];
+            compiled = Fail(&compiler, "next points past the last wave");
+        }
+    }
+
+    if (!compiled)
+        memset(table, 0, sizeof(WaveTable));
+
+    return compiled;
+}
+
+const WaveTable *GetDefaultWaves(void)
+{
+    static WaveTable table = {0};
+
+    if (table.waveCount == 0)
+        CompileWaves(defaultWaves, &table, NULL, 0);
+
+    return &table;
+}
@@ -0,0 +1,19 @@
+#ifndef WAVES_H
+#define WAVES_H
+
+#include <stdbool.h>
+#include "game.h"
+
+//------------------------------------------------------------------------------------
+// Module Functions Declaration
+//------------------------------------------------------------------------------------
+// Waves are defined in plain text, the format is described in Assets/waves.txt.
+// Compiling checks every line and lays the waves out as the flat tables of a WaveTable,
+// so the wave engine in game.c never parses or allocates while playing. On failure the
+// table is left empty and error receives "line N: reason".
+bool CompileWaves(const char *text, WaveTable *table, char *error, int errorSize);
+
+// The waves the game ships with, compiled on first use
+const WaveTable *GetDefaultWaves(void);
+
+#endif // WAVES_H